@@ -23,7 +23,7 @@
 #ifndef ADS129XX_CONSTANTS_H_
 #define ADS129XX_CONSTANTS_H_
 
-#include <Arduino.h>
+#include "ads129xHal.h"
 
 namespace ads {
 
@@ -92,9 +92,11 @@ const byte B_CLK_EN = 0x20;
 
 // FIXME: Datasheet says in 32 kSPS and 64 kSPS, the bits per channel send by ADS is 16 BUT ADS max sample frequency is 32 kSPS. Check it (page 53, Readback length) when new version of the datasheet is available.
 // High resolution mode
-#if ADS_BITS_PER_CHANNEL == 16
+// With ADS_RUNTIME_FRAME_WIDTH, every data rate can be used (the bits per channel follow CONFIG1)
+#if ADS_BITS_PER_CHANNEL == 16 || ADS_RUNTIME_FRAME_WIDTH
 const byte HIGH_RES_32k_SPS = B_HR | RESERVED_BITS;
-#elif ADS_BITS_PER_CHANNEL == 24
+#endif
+#if ADS_BITS_PER_CHANNEL == 24
 const byte HIGH_RES_16k_SPS = (B_HR | B_DR0 | RESERVED_BITS);
 const byte HIGH_RES_8k_SPS = (B_HR | B_DR1 | RESERVED_BITS);
 const byte HIGH_RES_4k_SPS = (B_HR | B_DR1 | B_DR0 | RESERVED_BITS);
@@ -111,6 +113,21 @@ const byte LOW_POWR_1k_SPS = B_DR2 | RESERVED_BITS;
 const byte LOW_POWR_500_SPS = (B_DR2 | B_DR0 | RESERVED_BITS);
 const byte LOW_POWR_250_SPS = (B_DR2 | B_DR1 | RESERVED_BITS);
 #endif
+
+// Data rate (in samples per second) set by a CONFIG1 value. High resolution mode: 32 kSPS for DR = 000, low power mode: 16 kSPS 
+// for DR = 000. Each DR step halves the data rate. DR = 111 isn't allowed ("do not use") and it's treated as DR = 110.
+inline uint16_t dataRate(byte config1Value) {
+  uint8_t dr = config1Value & (B_DR2 | B_DR1 | B_DR0);
+  if (dr > 6)
+    dr = 6;
+  return ((config1Value & B_HR) ? 32000 : 16000) >> dr;
+}
+
+// Bits per channel of the frames sent with a CONFIG1 value: 16 for DR = 000 (32 kSPS in high resolution mode and 16 kSPS
+// in low power mode), 24 otherwise. See page 53, section 9.4.1.3.2 Readback Length, in the datasheet
+inline uint8_t bitsPerChannel(byte config1Value) {
+  return (config1Value & (B_DR2 | B_DR1 | B_DR0)) == 0 ? 16 : 24;
+}
 }
 
 namespace config2 {
@@ -228,6 +245,13 @@ const byte TEMP = B_MUXn2 | RESERVED_BITS;
 const byte TEST_SIGNAL = (B_MUXn2 | B_MUXn0 | RESERVED_BITS);
 const byte RLD_DRP = (B_MUXn2 | B_MUXn1 | RESERVED_BITS);
 const byte RLD_DRN = (B_MUXn2 | B_MUXn1 | B_MUXn0 | RESERVED_BITS);
+
+// PGA gain set by a CHnSET value: 000 -> 6, 001 -> 1, 010 -> 2, 011 -> 3, 100 -> 4, 101 -> 8, 110 -> 12. 
+// GAIN = 111 isn't allowed and it's treated as 000.
+inline uint8_t gain(byte chnSetValue) {
+  static const uint8_t gains[8] = {6, 1, 2, 3, 4, 8, 12, 6};
+  return gains[(chnSetValue & (B_GAINn2 | B_GAINn1 | B_GAINn0)) >> 4];
+}
 }
 
 namespace rldSensp {
@@ -527,6 +551,9 @@ const byte WCTC_CH4P = (B_WCTC2 | B_WCTC1 | RESERVED_BITS);
 const byte WCTC_CH4N = (B_WCTC2 | B_WCTC1 | B_WCTC0 | RESERVED_BITS);
 }
 
+// Number of registers in the register map (from ID to WCT2). Useful to read all the registers with readAllRegisters()
+const byte N_REGISTERS = wct2::REG_ADDR + 1;
+
 } // End of the register namespace
 } // End of the ads namespace
 
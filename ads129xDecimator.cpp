@@ -0,0 +1,110 @@
+#include "ads129xDecimator.h"
+
+#include <string.h>
+
+namespace ads {
+namespace decimator {
+
+// First half of the symmetric taps (FIR_TAPS / 2 + 1 taps, the last one is the center tap) in Q2.30, with a DC gain of
+// 1 exactly. Weighted least squares design: 1 / (droop of the CIC filter) in [0, 0.15] and 0 in [0.35, 0.5] (frequencies
+// relative to the input rate of the FIR filter). The droop depends on cicRatio: there are tables for cicRatio = 1, ..., 8
+// and 16. The table for 16 is used with cicRatio >= 9 (the error of the passband is < 0.011 dB)
+const uint8_t _N_FIR_TABLES = 9;
+const int32_t FIR_COEFFICIENTS[_N_FIR_TABLES][FIR_TAPS / 2 + 1] = {
+  {223282, -61088, -1505527, 276294, 5750883, -737931, -16419628, 1448929, 39871769, -2265664, -94176397, 2928620, 334693493, 533687754}, // cicRatio = 1
+  {304037, -65020, -2043856, 242393, 7785413, -403954, -22137419, -209818, 53294282, 4588039, -122455952, -30739965, 353692164, 590041136}, // cicRatio = 2
+  {321322, -65382, -2158763, 231659, 8218128, -317489, -23345928, -614049, 56092412, 6179427, -128111433, -37686771, 357423100, 601409358}, // cicRatio = 3
+  {327559, -65477, -2200197, 227525, 8374035, -285178, -23780759, -763480, 57096229, 6762145, -130123306, -40174107, 358745337, 605461172}, // cicRatio = 4
+  {330479, -65514, -2219592, 225543, 8446994, -269854, -23984138, -834074, 57565207, 7036458, -131060276, -41335350, 359360253, 607349552}, // cicRatio = 5
+  {332074, -65533, -2230186, 224449, 8486838, -261431, -24095179, -872803, 57821120, 7186696, -131570781, -41968805, 359695056, 608378794}, // cicRatio = 6
+  {333039, -65544, -2236593, 223782, 8510936, -256318, -24162326, -896286, 57975824, 7277703, -131879124, -42351665, 359897196, 609000576}, // cicRatio = 7
+  {333666, -65551, -2240760, 223347, 8526605, -252986, -24205984, -911580, 58076393, 7336940, -132079460, -42600522, 360028498, 609404612}, // cicRatio = 8
+  {335208, -65567, -2250995, 222273, 8565093, -244777, -24313207, -949227, 58323317, 7482633, -132570988, -43211438, 360350545, 610396084}, // cicRatio = 16 or more
+};
+
+boolean setRatio(state_t &state, uint8_t ratio) {
+  if (ratio != 1 && (ratio < 2 || ratio > MAX_RATIO || ratio % 2 != 0))
+    return false;
+
+  state.ratio = ratio;
+  state.cicRatio = ratio == 1 ? 1 : ratio / 2;
+  // Gain of the CIC filter: cicRatio^4 <= 2^20. With gain <= 2^s, the inverse is 2^(s + 19) / gain in [2^18, 2^19],
+  // and comb * cicGain < 2^(23 + s) * 2^19 / gain * gain <= 2^62 with codes of 24 bits
+  uint32_t gain = 1;
+  for (uint8_t i = 0; i < CIC_STAGES; i++)
+    gain *= state.cicRatio;
+  uint8_t s = 0;
+  while ((1UL << s) < gain)
+    s++;
+  state.cicGain = (int32_t) (((1ULL << (s + 19)) + gain / 2) / gain);
+  state.cicShift = s + 19 - ads::filter::GUARD_BITS;
+  state.firCoefficients = FIR_COEFFICIENTS[state.cicRatio <= 8 ? state.cicRatio - 1 : _N_FIR_TABLES - 1];
+  reset(state);
+  return true;
+}
+
+void reset(state_t &state) {
+  state.cicPhase = 0;
+  state.firPhase = 0;
+  state.firIndex = 0;
+  memset(state.integrators, 0, sizeof(state.integrators));
+  memset(state.combs, 0, sizeof(state.combs));
+  memset(state.firSamples, 0, sizeof(state.firSamples));
+}
+
+uint32_t process(state_t &state, const int32_t *in, uint32_t nFrames, uint32_t inStride, int32_t *out) {
+  if (state.ratio == 1) {
+    for (uint32_t f = 0; f < nFrames; f++)
+      out[f] = in[f * inStride];
+    return nFrames;
+  }
+
+  // The integrators are copied to local variables, so the compiler keeps them in registers
+  uint64_t i0 = state.integrators[0], i1 = state.integrators[1], i2 = state.integrators[2], i3 = state.integrators[3];
+  uint8_t cicPhase = state.cicPhase;
+  uint32_t nOut = 0;
+  for (uint32_t f = 0; f < nFrames; f++) {
+    i0 += (uint64_t) (int64_t) in[f * inStride];
+    i1 += i0;
+    i2 += i1;
+    i3 += i2;
+    if (++cicPhase < state.cicRatio)
+      continue;
+    cicPhase = 0;
+
+    // Combs (the result is right although the integrators have wrapped around)
+    uint64_t v = i3;
+    for (uint8_t i = 0; i < CIC_STAGES; i++) {
+      uint64_t previous = state.combs[i];
+      state.combs[i] = v;
+      v -= previous;
+    }
+    state.firIndex = (state.firIndex + 1) & _FIR_BUFFER_MASK;
+    state.firSamples[state.firIndex] = (int32_t) (((int64_t) v * state.cicGain) >> state.cicShift);
+    if (++state.firPhase < 2)
+      continue;
+    state.firPhase = 0;
+
+    // FIR filter: the taps are symmetric, so the samples that share a tap are added first
+    const int32_t *h = state.firCoefficients;
+    const int32_t *x = state.firSamples;
+    uint8_t newest = state.firIndex;
+    uint8_t oldest = (state.firIndex - (FIR_TAPS - 1)) & _FIR_BUFFER_MASK;
+    int64_t acc = 0;
+    for (uint8_t k = 0; k < FIR_TAPS / 2; k++)
+      acc += (int64_t) h[k] * ((int64_t) x[(newest - k) & _FIR_BUFFER_MASK] + x[(oldest + k) & _FIR_BUFFER_MASK]);
+    acc += (int64_t) h[FIR_TAPS / 2] * x[(newest - FIR_TAPS / 2) & _FIR_BUFFER_MASK];
+    // Rounded to the nearest code
+    out[nOut++] = (int32_t) ((acc + (1LL << (29 + ads::filter::GUARD_BITS))) >> (30 + ads::filter::GUARD_BITS));
+  }
+
+  state.integrators[0] = i0;
+  state.integrators[1] = i1;
+  state.integrators[2] = i2;
+  state.integrators[3] = i3;
+  state.cicPhase = cicPhase;
+  return nOut;
+}
+
+} // End of the decimator namespace
+} // End of the ads namespace
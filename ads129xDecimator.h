@@ -0,0 +1,155 @@
+/*
+ * Decimator of the channels decoded from ADS129x frames: acquire at a high data rate (for example, 8 kSPS or 16 kSPS to
+ * detect pacemaker pulses) and get the channels at a low rate (for example, 500 SPS for the ECG). Every channel has its
+ * own ratio, so some channels can keep the full rate while the others are decimated.
+ *
+ * A ratio R is done in two stages (no floating point operation):
+ *   1. CIC filter (4 integrators, decimation by R / 2 and 4 combs). It needs no multiplication per sample. It grows
+ *      4 * log2(R / 2) bits (20 bits for R = 64), so the integrators and combs are 64 bits wide (they wrap around
+ *      without error). The gain (R / 2)^4 is removed with a multiplication by its inverse.
+ *   2. Compensating FIR filter (FIR_TAPS symmetric taps in Q2.30 and decimation by 2). It flattens the droop of the CIC
+ *      filter and removes the band that would be aliased by the last decimation.
+ * The passband is flat (ripple < 0.02 dB) up to 0.3 times the output rate (150 Hz with 500 SPS, the diagnostic ECG
+ * bandwidth). The group delay is getDelay() input samples. The bands aliased in the passband are attenuated at least:
+ *    ratio 2: 86 dB, ratio 4: 49 dB, ratio 6: 55 dB, ratio 8: 57 dB, ratios 10 to 24: 58 dB, ratio 26 or more: 60 dB
+ * The small ratios are limited by the CIC filter: the bands that it aliases in its own decimation are never seen by the
+ * FIR filter. If your signal has strong components above the output passband, use a ratio of 10 or more.
+ *
+ * The samples are the int32_t codes given by the decoder (see ads129xDecoder.h) and the output has the same scale.
+ * Averaging R samples lowers the noise, so the output has a better SNR than the input: the samples have
+ * ads::filter::GUARD_BITS extra bits of resolution between both stages (see ads129xFilter.h).
+ *
+ * The state of a channel needs ~220 bytes, so it's intended for boards with some RAM (ARM, ESP32, ...).
+ *
+ * Example (8 channels at 16 kSPS, channel 0 at full rate to detect pacemaker pulses, the others at 500 SPS):
+ *    ADS129xDecimator<8> decimator;
+ *    decimator.setRatio(32);
+ *    decimator.setRatio(0, 1);
+ *    ...
+ *    int32_t out[8][MAX_SPAN + 1]; // Room for nFrames / ratio + 1 samples per channel (channel 0 isn't decimated)
+ *    uint32_t nOut[8];
+ *    ads_frame_span_t span;
+ *    if (sensor.acquireFrames(&span, MAX_SPAN)) {
+ *      decimator.processFrames<ads_frame_traits_t>(span.frames, span.nFrames, &out[0][0], sizeof(out[0]) / sizeof(int32_t), nOut);
+ *      sensor.releaseFrames(&span);
+ *      // nOut[c] new samples of channel c in out[c]
+ *    }
+ */
+#ifndef _ADS129X_DECIMATOR_H_
+#define _ADS129X_DECIMATOR_H_
+
+#include "ads129xDecoder.h"
+#include "ads129xFilter.h"
+
+namespace ads {
+namespace decimator {
+
+const uint8_t CIC_STAGES = 4;
+const uint8_t MAX_CIC_RATIO = 32;
+const uint8_t MAX_RATIO = 2 * MAX_CIC_RATIO;
+const uint8_t FIR_TAPS = 27;
+const uint8_t _FIR_BUFFER_SIZE = 32; // Power of 2 >= FIR_TAPS
+const uint8_t _FIR_BUFFER_MASK = _FIR_BUFFER_SIZE - 1;
+
+// State of one channel
+struct state_t {
+  uint8_t ratio; // 1 (no decimation) or an even number between 2 and MAX_RATIO
+  uint8_t cicRatio; // ratio / 2
+  uint8_t cicShift; // Output of the CIC filter = (comb * cicGain) >> cicShift
+  int32_t cicGain;
+  const int32_t *firCoefficients; // First half of the taps of the FIR filter (they depend on cicRatio)
+  uint8_t cicPhase; // Input samples of the current CIC output
+  uint64_t integrators[CIC_STAGES]; // They wrap around, so they are unsigned
+  uint64_t combs[CIC_STAGES]; // Last input of every comb
+  uint8_t firPhase; // Samples of the current FIR output (0 or 1)
+  uint8_t firIndex; // Position of the last sample in firSamples
+  int32_t firSamples[_FIR_BUFFER_SIZE]; // Last outputs of the CIC filter (with GUARD_BITS extra bits)
+};
+
+// Set the ratio of a channel and clear its state. Return false (and nothing is changed) if ratio isn't 1 or an even
+// number between 2 and MAX_RATIO
+boolean setRatio(state_t &state, uint8_t ratio);
+// Clear the state, the ratio is kept
+void reset(state_t &state);
+// Decimate nFrames samples that are inStride values apart. Return the number of output samples (<= nFrames / ratio + 1)
+uint32_t process(state_t &state, const int32_t *in, uint32_t nFrames, uint32_t inStride, int32_t *out);
+
+} // End of the decimator namespace
+} // End of the ads namespace
+
+/* ======= ADS129xDecimator class definition  ============= */
+// Decimator of nChannels channels. All the ratios are 1 (no decimation) until setRatio() is called
+template <uint8_t nChannels>
+class ADS129xDecimator {
+  private:
+    ads::decimator::state_t state[nChannels];
+    static const uint8_t _TILE_FRAMES = 8; // Frames decoded at once by processFrames()
+
+  public:
+    ADS129xDecimator() {
+      setRatio(1);
+    }
+
+    // Set the ratio of a channel (see ads::decimator::setRatio()) and clear its state
+    boolean setRatio(uint8_t channel, uint8_t ratio) {
+      if (channel >= nChannels)
+        return false;
+      return ads::decimator::setRatio(state[channel], ratio);
+    }
+    // The same for all channels
+    boolean setRatio(uint8_t ratio) {
+      for (uint8_t c = 0; c < nChannels; c++) {
+        if (!ads::decimator::setRatio(state[c], ratio))
+          return false;
+      }
+      return true;
+    }
+    uint8_t getRatio(uint8_t channel) {
+      return state[channel].ratio;
+    }
+    // Group delay of a channel in input samples: a pulse in input sample i is in output sample (i + getDelay()) / ratio.
+    // Use it to align the channels that have different ratios
+    uint16_t getDelay(uint8_t channel) {
+      const ads::decimator::state_t &s = state[channel];
+      if (s.ratio == 1)
+        return 0;
+      // CIC: CIC_STAGES * (cicRatio - 1) / 2. FIR: (FIR_TAPS - 1) / 2 CIC outputs
+      return ads::decimator::CIC_STAGES * (s.cicRatio - 1) / 2 + (ads::decimator::FIR_TAPS - 1) / 2 * s.cicRatio;
+    }
+    // Clear the state of all channels (for example, after a gap in the samples)
+    void reset() {
+      for (uint8_t c = 0; c < nChannels; c++)
+        ads::decimator::reset(state[c]);
+    }
+
+    // Decimate nFrames frames with the per-channel layout: columns[c * stride + f] (see decodeFramesToColumns()). The
+    // nOut[c] output samples of channel c are in out[c * outStride + k]. outStride must be >= nFrames / ratio + 1
+    void processColumns(const int32_t *columns, uint32_t nFrames, uint32_t stride, int32_t *out, uint32_t outStride,
+                        uint32_t *nOut) {
+      for (uint8_t c = 0; c < nChannels; c++)
+        nOut[c] = ads::decimator::process(state[c], columns + c * stride, nFrames, 1, out + c * outStride);
+    }
+    // The same with the frame by frame layout: samples[f * nChannels + c] (see decodeFrames())
+    void processInterleaved(const int32_t *samples, uint32_t nFrames, int32_t *out, uint32_t outStride, uint32_t *nOut) {
+      for (uint8_t c = 0; c < nChannels; c++)
+        nOut[c] = ads::decimator::process(state[c], samples + c, nFrames, nChannels, out + c * outStride);
+    }
+    // Decode and decimate nFrames frames (for example, the frames of a span of the ring buffer). The output is the same
+    // as processColumns(). Frames are decoded in small tiles, so no buffer for the decoded frames is needed.
+    // Frame::TOTAL_CHANNELS must be nChannels
+    template <class Frame>
+    void processFrames(const typename Frame::data_t *frames, uint32_t nFrames, int32_t *out, uint32_t outStride, uint32_t *nOut) {
+      static_assert(Frame::TOTAL_CHANNELS == nChannels, "The frames must have nChannels channels");
+      int32_t tile[_TILE_FRAMES * nChannels];
+      for (uint8_t c = 0; c < nChannels; c++)
+        nOut[c] = 0;
+      for (uint32_t f = 0; f < nFrames; f += _TILE_FRAMES) {
+        uint32_t n = nFrames - f < _TILE_FRAMES ? nFrames - f : _TILE_FRAMES;
+        ads::decoder::decodeFrames<Frame>(frames + f, n, tile);
+        for (uint8_t c = 0; c < nChannels; c++)
+          nOut[c] += ads::decimator::process(state[c], tile + c, n, nChannels, out + c * outStride + nOut[c]);
+      }
+    }
+};
+
+#endif /* _ADS129X_DECIMATOR_H_ */
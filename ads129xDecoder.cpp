@@ -0,0 +1,62 @@
+#include "ads129xDecoder.h"
+
+namespace ads {
+namespace decoder {
+
+// Frames of the chip model set in ads129xDriverConfig.h
+void decodeFrames(const ads_data_t *frames, uint32_t nFrames, int32_t *out) {
+  decodeFrames<ads_frame_traits_t>(frames, nFrames, out);
+}
+
+void decodeFrames(const ads_data_t *frames, uint32_t nFrames, const float *lsb, float *out) {
+  decodeFrames<ads_frame_traits_t>(frames, nFrames, lsb, out);
+}
+
+void decodeFramesToColumns(const ads_data_t *frames, uint32_t nFrames, int32_t *columns, uint32_t stride, uint32_t *status) {
+  decodeFramesToColumns<ads_frame_traits_t>(frames, nFrames, columns, stride, status);
+}
+
+void decodeFramesToColumns(const ads_data_t *frames, uint32_t nFrames, const float *lsb, float *columns, uint32_t stride,
+                           uint32_t *status) {
+  decodeFramesToColumns<ads_frame_traits_t>(frames, nFrames, lsb, columns, stride, status);
+}
+
+#if ADS_RUNTIME_FRAME_WIDTH
+// 16 bits frames are in ads_data_t slots -> ads_frame16_traits_t has the same stride
+static const ads_data16_t * _asFrames16(const ads_data_t *frames) {
+  return (const ads_data16_t *) frames;
+}
+
+void decodeFrames(const ads_data_t *frames, uint32_t nFrames, uint8_t bitsPerChannel, int32_t *out) {
+  if (bitsPerChannel == 16)
+    decodeFrames<ads_frame16_traits_t>(_asFrames16(frames), nFrames, out);
+  else
+    decodeFrames<ads_frame_traits_t>(frames, nFrames, out);
+}
+
+void decodeFrames(const ads_data_t *frames, uint32_t nFrames, uint8_t bitsPerChannel, const float *lsb, float *out) {
+  if (bitsPerChannel == 16)
+    decodeFrames<ads_frame16_traits_t>(_asFrames16(frames), nFrames, lsb, out);
+  else
+    decodeFrames<ads_frame_traits_t>(frames, nFrames, lsb, out);
+}
+
+void decodeFramesToColumns(const ads_data_t *frames, uint32_t nFrames, uint8_t bitsPerChannel, int32_t *columns,
+                           uint32_t stride, uint32_t *status) {
+  if (bitsPerChannel == 16)
+    decodeFramesToColumns<ads_frame16_traits_t>(_asFrames16(frames), nFrames, columns, stride, status);
+  else
+    decodeFramesToColumns<ads_frame_traits_t>(frames, nFrames, columns, stride, status);
+}
+
+void decodeFramesToColumns(const ads_data_t *frames, uint32_t nFrames, uint8_t bitsPerChannel, const float *lsb,
+                           float *columns, uint32_t stride, uint32_t *status) {
+  if (bitsPerChannel == 16)
+    decodeFramesToColumns<ads_frame16_traits_t>(_asFrames16(frames), nFrames, lsb, columns, stride, status);
+  else
+    decodeFramesToColumns<ads_frame_traits_t>(frames, nFrames, lsb, columns, stride, status);
+}
+#endif
+
+} // End of the decoder namespace
+} // End of the ads namespace
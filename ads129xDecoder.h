@@ -0,0 +1,337 @@
+/*
+ * Block decoder of the frames sent by ADS129x chips.
+ *
+ * The channels of an ads_data_t are big-endian binary two's complement numbers of ADS_BITS_PER_CHANNEL bits (see page 53,
+ * section 9.4.1.3 Data Output, in the datasheet). These functions convert a contiguous run of frames (for example, the frames
+ * returned by ADS129xSensor::peek() up to ADS129xSensor::availableContiguous()) in sign-extended int32_t values or in
+ * float values scaled by the LSB of each channel. Status words are skipped.
+ *
+ * The output is frame by frame: out[f * ADS_TOTAL_CHANNELS + c] is the channel c of the frame f. In daisy-chain, channel c
+ * is the channel c % ADS_N_CHANNELS of the device c / ADS_N_CHANNELS (the same order than ads_daisy_frame_t).
+ *
+ * decodeFrames(const ads_data_t *, ...) decodes the frames of the chip model set in ads129xDriverConfig.h. The template
+ * versions decode the frames of any model (see ads::frame_traits in ads129xFrame.h) and they are specialized at compile
+ * time, for example: ads::decoder::decodeFrames<ads::frame_traits<ADS_1298, 24> >(frames, nFrames, out)
+ *
+ * decodeFramesToColumns() writes the channels with the per-channel layout (struct of arrays) that filters and other DSP
+ * stages want: columns[c * stride + f] is the channel c of the frame f, so every channel is a contiguous array. The
+ * status words go to another array. Use column_block_t to get columns aligned to cache lines (64 bytes) with a stride
+ * that keeps all of them aligned.
+ *
+ * If ADS_RUNTIME_FRAME_WIDTH is 1 (see ads129xDriverConfig.h), the ring buffer has 24 bits and 16 bits frames (the bits
+ * per channel follow the data rate). The versions with a bitsPerChannel argument decode a run of frames of the same width
+ * (for example, a span of ADS129xSensor::acquireFrames() with span.info[0].bitsPerChannel) with the kernels of that width:
+ * the width is checked once per call, not per frame. The LSB of 16 bits channels is lsbVolts(vref, gain, 16).
+ *
+ * The decoder uses SIMD instructions when the compiler targets them (AVX2, SSSE3 or NEON) and a portable version
+ * otherwise (for example, in Arduino boards). Define ADS_DECODER_NO_SIMD to use always the portable version.
+ */
+#ifndef _ADS129X_DECODER_H_
+#define _ADS129X_DECODER_H_
+
+#include "ads129xDriver.h"
+
+// SIMD instructions available. AVX2 versions are only used when a device has more than 4 channels (ADS1296 and ADS1298)
+#if !defined(ADS_DECODER_NO_SIMD)
+#if defined(__AVX2__)
+#define _ADS_DECODER_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__SSSE3__)
+// SSE2 doesn't have a byte shuffle instruction -> SSSE3 is needed
+#define _ADS_DECODER_SSSE3
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#define _ADS_DECODER_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace ads {
+namespace decoder {
+
+// Decode one sample
+inline int32_t decodeSample(const bits_sample_t<16> &sample) {
+  return (int16_t) ((sample.hi << 8) | sample.low);
+}
+
+inline int32_t decodeSample(const bits_sample_t<24> &sample) {
+  return (int32_t) ((uint32_t) sample.hi << 24 | (uint32_t) sample.mid << 16 | (uint32_t) sample.low << 8) >> 8;
+}
+
+// Value of one LSB (in volts) of a channel with gain (1, 2, 3, 4, 6, 8 or 12) and the reference voltage vref (in volts).
+// 1 LSB = (2 * VREF / gain) / (2^bits - 1). See page 53, section 9.4.1.3 Data Output, in the datasheet
+inline float lsbVolts(float vref, uint8_t gain, uint8_t bits = ADS_BITS_PER_CHANNEL) {
+  return 2 * vref / gain / ((1UL << bits) - 1);
+}
+
+// Decode the channels of nFrames frames in out (nFrames * ADS_TOTAL_CHANNELS values)
+void decodeFrames(const ads_data_t *frames, uint32_t nFrames, int32_t *out);
+// Decode the channels of nFrames frames in out (nFrames * ADS_TOTAL_CHANNELS values) multiplied by the LSB of their
+// channel: lsb[c] is the LSB of the channel c (ADS_TOTAL_CHANNELS values, see lsbVolts())
+void decodeFrames(const ads_data_t *frames, uint32_t nFrames, const float *lsb, float *out);
+
+/* ======= Per-channel layout (struct of arrays) ============= */
+const uint8_t COLUMN_ALIGNMENT = 64; // Bytes (a cache line)
+
+// Stride (in values) of the columns of nFrames frames: nFrames rounded up to a multiple of 16 values (64 bytes), so every
+// column starts in a cache line when the first one does
+inline uint32_t columnStride(uint32_t nFrames) {
+  return (nFrames + 15) & ~(uint32_t) 15;
+}
+
+// Columns of nFrames frames. Example:
+//    static ads::decoder::column_block_t<ads_frame_traits_t, 64> block;
+//    ads::decoder::decodeFramesToColumns(frames, 64, block.channel[0], block.STRIDE, block.status);
+//    filter(block.channel[2], 64); // Channel 2 of the 64 frames
+template <class Frame, uint32_t nFrames, class T = int32_t>
+struct column_block_t {
+  static constexpr uint32_t STRIDE = (nFrames + 15) & ~(uint32_t) 15;
+  alignas(COLUMN_ALIGNMENT) T channel[Frame::TOTAL_CHANNELS][STRIDE];
+  uint32_t status[nFrames * Frame::N_DEVICES];
+};
+
+// Decode the channels of nFrames frames in columns: columns[c * stride + f] is the channel c of the frame f (stride >= nFrames).
+// If status isn't NULL, status[f * ADS_DAISY_CHAIN_DEVICES + d] is the 24 bits status word of the device d in the frame f
+void decodeFramesToColumns(const ads_data_t *frames, uint32_t nFrames, int32_t *columns, uint32_t stride, uint32_t *status = NULL);
+// The same but the channels are multiplied by the LSB of their channel (see decodeFrames())
+void decodeFramesToColumns(const ads_data_t *frames, uint32_t nFrames, const float *lsb, float *columns, uint32_t stride,
+                           uint32_t *status = NULL);
+
+#if ADS_RUNTIME_FRAME_WIDTH
+// The same for frames of bitsPerChannel (16 or 24) bits per channel stored in ads_data_t slots
+void decodeFrames(const ads_data_t *frames, uint32_t nFrames, uint8_t bitsPerChannel, int32_t *out);
+void decodeFrames(const ads_data_t *frames, uint32_t nFrames, uint8_t bitsPerChannel, const float *lsb, float *out);
+void decodeFramesToColumns(const ads_data_t *frames, uint32_t nFrames, uint8_t bitsPerChannel, int32_t *columns,
+                           uint32_t stride, uint32_t *status = NULL);
+void decodeFramesToColumns(const ads_data_t *frames, uint32_t nFrames, uint8_t bitsPerChannel, const float *lsb,
+                           float *columns, uint32_t stride, uint32_t *status = NULL);
+#endif
+
+/* ======= Template versions (Frame is an ads::frame_traits) ============= */
+template <class Frame>
+void decodeFrames(const typename Frame::data_t *frames, uint32_t nFrames, int32_t *out);
+template <class Frame>
+void decodeFrames(const typename Frame::data_t *frames, uint32_t nFrames, const float *lsb, float *out);
+template <class Frame>
+void decodeFramesToColumns(const typename Frame::data_t *frames, uint32_t nFrames, int32_t *columns, uint32_t stride,
+                           uint32_t *status = NULL);
+template <class Frame>
+void decodeFramesToColumns(const typename Frame::data_t *frames, uint32_t nFrames, const float *lsb, float *columns,
+                           uint32_t stride, uint32_t *status = NULL);
+
+
+/* ======= Implementation ============= */
+template <uint8_t nChannels, uint8_t bits>
+inline void _decodeDevicePortable(const bits_sample_t<bits> *samples, int32_t *out) {
+  for (uint8_t i = 0; i < nChannels; i++)
+    out[i] = decodeSample(samples[i]);
+}
+
+// SIMD versions load more bytes than the channels of the device (up to 12 bytes). These bytes belong to the next device or
+// frame of the run (the smallest device data has 11 bytes), so the last device of the run is decoded with the portable version.
+#if defined(_ADS_DECODER_SSSE3)
+// Four samples starting at p. Each sample is moved to the 3 (24 bits) or 2 (16 bits) upper bytes of its lane and the
+// arithmetic shift does the sign extension
+template <uint8_t bits>
+inline __m128i _decode4Samples(const byte *p) {
+  if (bits == 24) {
+    const __m128i shuffle = _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+    return _mm_srai_epi32(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) p), shuffle), 8);
+  }
+  const __m128i shuffle = _mm_setr_epi8(-1, -1, 1, 0, -1, -1, 3, 2, -1, -1, 5, 4, -1, -1, 7, 6);
+  return _mm_srai_epi32(_mm_shuffle_epi8(_mm_loadl_epi64((const __m128i *) p), shuffle), 16);
+}
+#endif
+
+#if defined(_ADS_DECODER_AVX2)
+// Eight samples starting at p
+template <uint8_t bits>
+inline __m256i _decode8Samples(const byte *p) {
+  if (bits == 24) {
+    const __m128i shuffle = _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+    // Shuffle doesn't cross the 128 bits lanes -> samples 0-3 go to the lower lane and samples 4-7 to the upper lane
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) p)),
+                                        _mm_loadu_si128((const __m128i *) (p + 12)), 1);
+    return _mm256_srai_epi32(_mm256_shuffle_epi8(v, _mm256_broadcastsi128_si256(shuffle)), 8);
+  }
+  const __m128i swapBytes = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+  return _mm256_cvtepi16_epi32(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) p), swapBytes));
+}
+#endif
+
+#if defined(_ADS_DECODER_NEON)
+// Eight samples starting at p. vld3/vld2 split the bytes of the samples (hi, mid and low bytes) in different registers
+template <uint8_t bits>
+inline void _decode8Samples(const byte *p, int32x4_t *first4, int32x4_t *last4) {
+  if (bits == 24) {
+    uint8x8x3_t bytes = vld3_u8(p);
+    uint16x8_t hiMid = vorrq_u16(vshll_n_u8(bytes.val[0], 8), vmovl_u8(bytes.val[1]));
+    uint16x8_t low = vmovl_u8(bytes.val[2]);
+    *first4 = vshrq_n_s32(vreinterpretq_s32_u32(vorrq_u32(vshll_n_u16(vget_low_u16(hiMid), 16), vshll_n_u16(vget_low_u16(low), 8))), 8);
+    *last4 = vshrq_n_s32(vreinterpretq_s32_u32(vorrq_u32(vshll_n_u16(vget_high_u16(hiMid), 16), vshll_n_u16(vget_high_u16(low), 8))), 8);
+  } else {
+    uint8x8x2_t bytes = vld2_u8(p);
+    int16x8_t samples = vreinterpretq_s16_u16(vorrq_u16(vshll_n_u8(bytes.val[0], 8), vmovl_u8(bytes.val[1])));
+    *first4 = vmovl_s16(vget_low_s16(samples));
+    *last4 = vmovl_s16(vget_high_s16(samples));
+  }
+}
+#endif
+
+// The conditions only depend on template arguments -> the compiler keeps only one branch
+template <uint8_t nChannels, uint8_t bits>
+inline void _decodeDevice(const bits_sample_t<bits> *samples, int32_t *out) {
+#if defined(_ADS_DECODER_SSSE3) || defined(_ADS_DECODER_NEON)
+  const byte *p = (const byte *) samples;
+#endif
+#if defined(_ADS_DECODER_AVX2)
+  if (nChannels == 8) {
+    _mm256_storeu_si256((__m256i *) out, _decode8Samples<bits>(p));
+    return;
+  }
+  if (nChannels == 6 && bits == 24) {
+    _mm256_maskstore_epi32((int *) out, _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0), _decode8Samples<bits>(p));
+    return;
+  }
+#endif
+#if defined(_ADS_DECODER_SSSE3)
+  uint8_t i = 0;
+  for (; i + 4 <= nChannels; i += 4)
+    _mm_storeu_si128((__m128i *) (out + i), _decode4Samples<bits>(p + i * bits / 8));
+  if (i < nChannels) // 2 channels left (ADS1296)
+    _mm_storel_epi64((__m128i *) (out + i), _decode4Samples<bits>(p + i * bits / 8));
+#elif defined(_ADS_DECODER_NEON)
+  int32x4_t first4, last4;
+  _decode8Samples<bits>(p, &first4, &last4);
+  vst1q_s32(out, first4);
+  if (nChannels == 8)
+    vst1q_s32(out + 4, last4);
+  else if (nChannels == 6)
+    vst1_s32(out + 4, vget_low_s32(last4));
+#else
+  _decodeDevicePortable<nChannels, bits>(samples, out);
+#endif
+}
+
+template <class Frame>
+void decodeFrames(const typename Frame::data_t *frames, uint32_t nFrames, int32_t *out) {
+  for (uint32_t f = 0; f < nFrames; f++) {
+    for (uint8_t d = 0; d < Frame::N_DEVICES; d++) {
+      // SIMD versions would read after the end of the run
+      if (f + 1 == nFrames && d + 1 == Frame::N_DEVICES)
+        _decodeDevicePortable<Frame::N_CHANNELS, Frame::BITS_PER_CHANNEL>(frames[f].device[d].channel, out);
+      else
+        _decodeDevice<Frame::N_CHANNELS, Frame::BITS_PER_CHANNEL>(frames[f].device[d].channel, out);
+      out += Frame::N_CHANNELS;
+    }
+  }
+}
+
+template <class Frame>
+void decodeFrames(const typename Frame::data_t *frames, uint32_t nFrames, const float *lsb, float *out) {
+  int32_t codes[Frame::N_CHANNELS];
+  for (uint32_t f = 0; f < nFrames; f++) {
+    for (uint8_t d = 0; d < Frame::N_DEVICES; d++) {
+      if (f + 1 == nFrames && d + 1 == Frame::N_DEVICES)
+        _decodeDevicePortable<Frame::N_CHANNELS, Frame::BITS_PER_CHANNEL>(frames[f].device[d].channel, codes);
+      else
+        _decodeDevice<Frame::N_CHANNELS, Frame::BITS_PER_CHANNEL>(frames[f].device[d].channel, codes);
+      // The compiler vectorizes this loop (int to float conversion and multiplication)
+      const float *deviceLsb = lsb + d * Frame::N_CHANNELS;
+      for (uint8_t i = 0; i < Frame::N_CHANNELS; i++)
+        out[i] = codes[i] * deviceLsb[i];
+      out += Frame::N_CHANNELS;
+    }
+  }
+}
+
+// Write a value of the column (lsb is ignored by the int32_t version)
+inline void _storeColumnValue(int32_t *column, int32_t code, float lsb) {
+  (void) lsb;
+  *column = code;
+}
+
+inline void _storeColumnValue(float *column, int32_t code, float lsb) {
+  *column = code * lsb;
+}
+
+#if defined(_ADS_DECODER_SSSE3)
+// Write 4 consecutive values of the column
+inline void _storeColumn4(int32_t *column, __m128i codes, float lsb) {
+  (void) lsb;
+  _mm_storeu_si128((__m128i *) column, codes);
+}
+
+inline void _storeColumn4(float *column, __m128i codes, float lsb) {
+  _mm_storeu_ps(column, _mm_mul_ps(_mm_cvtepi32_ps(codes), _mm_set1_ps(lsb)));
+}
+#endif
+
+// Frames are decoded in tiles of 4 frames (4 rows of TOTAL_CHANNELS values) and every tile is transposed to the columns.
+// With SSE, 4 channels x 4 frames are transposed in registers
+template <class Frame, class T>
+void _decodeFramesToColumns(const typename Frame::data_t *frames, uint32_t nFrames, const float *lsb, T *columns,
+                            uint32_t stride, uint32_t *status) {
+  const uint8_t TOTAL = Frame::TOTAL_CHANNELS;
+  int32_t tile[4][TOTAL];
+  for (uint32_t f0 = 0; f0 < nFrames; f0 += 4) {
+    uint8_t nRows = nFrames - f0 < 4 ? nFrames - f0 : 4;
+    for (uint8_t j = 0; j < nRows; j++) {
+      const typename Frame::data_t &frame = frames[f0 + j];
+      for (uint8_t d = 0; d < Frame::N_DEVICES; d++) {
+        // SIMD versions would read after the end of the run
+        if (f0 + j + 1 == nFrames && d + 1 == Frame::N_DEVICES)
+          _decodeDevicePortable<Frame::N_CHANNELS, Frame::BITS_PER_CHANNEL>(frame.device[d].channel, tile[j] + d * Frame::N_CHANNELS);
+        else
+          _decodeDevice<Frame::N_CHANNELS, Frame::BITS_PER_CHANNEL>(frame.device[d].channel, tile[j] + d * Frame::N_CHANNELS);
+        if (status != NULL) {
+          const byte *s = frame.device[d].statusWord;
+          status[(f0 + j) * Frame::N_DEVICES + d] = (uint32_t) s[0] << 16 | (uint32_t) s[1] << 8 | s[2];
+        }
+      }
+    }
+
+    uint8_t c = 0;
+#if defined(_ADS_DECODER_SSSE3)
+    if (nRows == 4) {
+      for (; c + 4 <= TOTAL; c += 4) {
+        __m128i r0 = _mm_loadu_si128((const __m128i *) (tile[0] + c));
+        __m128i r1 = _mm_loadu_si128((const __m128i *) (tile[1] + c));
+        __m128i r2 = _mm_loadu_si128((const __m128i *) (tile[2] + c));
+        __m128i r3 = _mm_loadu_si128((const __m128i *) (tile[3] + c));
+        __m128i t0 = _mm_unpacklo_epi32(r0, r1); // c0f0 c0f1 c1f0 c1f1
+        __m128i t1 = _mm_unpacklo_epi32(r2, r3); // c0f2 c0f3 c1f2 c1f3
+        __m128i t2 = _mm_unpackhi_epi32(r0, r1); // c2f0 c2f1 c3f0 c3f1
+        __m128i t3 = _mm_unpackhi_epi32(r2, r3); // c2f2 c2f3 c3f2 c3f3
+        _storeColumn4(columns + (c + 0) * stride + f0, _mm_unpacklo_epi64(t0, t1), lsb != NULL ? lsb[c + 0] : 0);
+        _storeColumn4(columns + (c + 1) * stride + f0, _mm_unpackhi_epi64(t0, t1), lsb != NULL ? lsb[c + 1] : 0);
+        _storeColumn4(columns + (c + 2) * stride + f0, _mm_unpacklo_epi64(t2, t3), lsb != NULL ? lsb[c + 2] : 0);
+        _storeColumn4(columns + (c + 3) * stride + f0, _mm_unpackhi_epi64(t2, t3), lsb != NULL ? lsb[c + 3] : 0);
+      }
+    }
+#endif
+    for (; c < TOTAL; c++) {
+      T *column = columns + c * stride + f0;
+      for (uint8_t j = 0; j < nRows; j++)
+        _storeColumnValue(column + j, tile[j][c], lsb != NULL ? lsb[c] : 0);
+    }
+  }
+}
+
+template <class Frame>
+void decodeFramesToColumns(const typename Frame::data_t *frames, uint32_t nFrames, int32_t *columns, uint32_t stride,
+                           uint32_t *status) {
+  _decodeFramesToColumns<Frame, int32_t>(frames, nFrames, NULL, columns, stride, status);
+}
+
+template <class Frame>
+void decodeFramesToColumns(const typename Frame::data_t *frames, uint32_t nFrames, const float *lsb, float *columns,
+                           uint32_t stride, uint32_t *status) {
+  _decodeFramesToColumns<Frame, float>(frames, nFrames, lsb, columns, stride, status);
+}
+
+} // End of the decoder namespace
+} // End of the ads namespace
+
+#endif /* _ADS129X_DECODER_H_ */
@@ -1,15 +1,14 @@
 #include "ads129xDriver.h"
 
-#include <Arduino.h>
-#include <SPI.h>
+using namespace ads;
 
 #if ADS_LIBRARY_VERBOSE_LEVEL > 0
 // Code are wrapped in {} because must be treated as one line of code
 #define _ADS_WARNING(msg) \
-  {Serial.print("Warning: "); \
-    Serial.println(msg); \
-    Serial.println("Stopping program execution"); \
-    while (1); }
+  {hal::print("Warning: "); \
+    hal::println(msg); \
+    hal::println("Stopping program execution"); \
+    hal::halt(); }
 #else
 #define _ADS_WARNING(msg) ; // Do nothing
 #endif
@@ -17,121 +16,251 @@
 #if ADS_LIBRARY_VERBOSE_LEVEL > 0
 // Code are wrapped in {} because must be treated as one line of code
 #define _ADS_ERROR(msg) \
-  {Serial.print("Error: "); \
-    Serial.println(msg); \
-    Serial.println("Stopping program execution"); \
-    while (1); }
+  {hal::print("Error: "); \
+    hal::println(msg); \
+    hal::println("Stopping program execution"); \
+    hal::halt(); }
 #else
-#define _ADS_ERROR(msg) while(1);
+#define _ADS_ERROR(msg) hal::halt();
 #endif
 
 /* ======= Wrapper to workaround the attachInterrupt limitation  ============= */
 // Attach interrupt doesn't work with methods in class. Only with global functions or static methods.
-// To workaround and to avoid declare multitud methods of ADS129xSensor as statics, I keep a instance
-// of the class in a global variable and call the right function from a global function
-ADS129xSensor *_ADS129xSensorPrivateInstance_ = 0; // Pointer to ADS129xx instance. It is used to call
+// To workaround and to avoid declare multitud methods of ADS129xChipSensor as statics, each initialized instance takes
+// a slot of a fixed-size registry and its interruptions are attached to global functions (one per slot and sensor type)
+// that call the instance of their slot. The sensors of all chip models share the registry
+#if ADS_MAX_SENSORS < 1 || ADS_MAX_SENSORS > 4
+#error "ADS_MAX_SENSORS must be between 1 and 4"
+#endif
+
+void *_ADS129xSensorPrivateInstances_[ADS_MAX_SENSORS] = {NULL}; // Instance of each slot. NULL if the slot is free
+
+// An asynchronous frame transfer is in progress (the SPI transaction is open). All sensors share the SPI bus, so it's shared too
+static volatile boolean _asyncFrameReadInFlight = false;
 
+#if ADS_ASYNC_FRAME_READ
+// Function that calls the deferred DRDY interruption of the instance of each slot. NULL if the slot is free
+static void (*_ADS129xSensorPrivateDeferredDrdys_[ADS_MAX_SENSORS])() = {NULL};
+
+// Call the deferred DRDY interruptions of all sensors until one of them starts another asynchronous read
+static void _runDeferredDrdys() {
+  for (uint8_t i = 0; i < ADS_MAX_SENSORS && !_asyncFrameReadInFlight; i++) {
+    if (_ADS129xSensorPrivateDeferredDrdys_[i] != NULL)
+      _ADS129xSensorPrivateDeferredDrdys_[i]();
+  }
+}
+#endif
+
+template <class sensor_t, uint8_t slot>
 void _ISR_ADS_privateReadDataFromChip_() {
-  _ADS129xSensorPrivateInstance_->_privateReadDataFromChip_();
+  ((sensor_t *) _ADS129xSensorPrivateInstances_[slot])->_privateReadDataFromChip_();
 }
 
-void ADS129xSensor::begin() {
-  // Add this class to the instance
-  if (_ADS129xSensorPrivateInstance_ == 0)
-    _ADS129xSensorPrivateInstance_ = this;
-  else {
-    _ADS_ERROR("The library allows only one ADS129xSensor object to be inicialized. You must call end() method in the other ADS129xSensor");
+template <class sensor_t, uint8_t slot>
+void _ISR_ADS_privateFrameReadCompleted_() {
+  ((sensor_t *) _ADS129xSensorPrivateInstances_[slot])->_privateFrameReadCompleted_();
+}
+
+#if ADS_ASYNC_FRAME_READ
+template <class sensor_t, uint8_t slot>
+void _ISR_ADS_privateRunDeferredDrdy_() {
+  ((sensor_t *) _ADS129xSensorPrivateInstances_[slot])->_privateRunDeferredDrdy_();
+}
+#endif
+
+// Only the functions of the ADS_MAX_SENSORS slots are generated
+#if ADS_MAX_SENSORS == 1
+#define _ADS_SLOT_FUNCTIONS(function) {function<sensor_t, 0>}
+#elif ADS_MAX_SENSORS == 2
+#define _ADS_SLOT_FUNCTIONS(function) {function<sensor_t, 0>, function<sensor_t, 1>}
+#elif ADS_MAX_SENSORS == 3
+#define _ADS_SLOT_FUNCTIONS(function) {function<sensor_t, 0>, function<sensor_t, 1>, function<sensor_t, 2>}
+#else
+#define _ADS_SLOT_FUNCTIONS(function) {function<sensor_t, 0>, function<sensor_t, 1>, function<sensor_t, 2>, function<sensor_t, 3>}
+#endif
+
+// Functions of each slot for the sensors of type sensor_t
+template <class sensor_t>
+struct _ads_slot_isrs_t {
+  static void (* const readDataFromChip[ADS_MAX_SENSORS])();
+  static void (* const frameReadCompleted[ADS_MAX_SENSORS])();
+#if ADS_ASYNC_FRAME_READ
+  static void (* const runDeferredDrdy[ADS_MAX_SENSORS])();
+#endif
+};
+
+template <class sensor_t>
+void (* const _ads_slot_isrs_t<sensor_t>::readDataFromChip[ADS_MAX_SENSORS])() = _ADS_SLOT_FUNCTIONS(_ISR_ADS_privateReadDataFromChip_);
+
+template <class sensor_t>
+void (* const _ads_slot_isrs_t<sensor_t>::frameReadCompleted[ADS_MAX_SENSORS])() = _ADS_SLOT_FUNCTIONS(_ISR_ADS_privateFrameReadCompleted_);
+
+#if ADS_ASYNC_FRAME_READ
+template <class sensor_t>
+void (* const _ads_slot_isrs_t<sensor_t>::runDeferredDrdy[ADS_MAX_SENSORS])() = _ADS_SLOT_FUNCTIONS(_ISR_ADS_privateRunDeferredDrdy_);
+#endif
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::begin() {
+  beginAsync();
+  // The same sequence, waiting here for every step
+  while (!poll()) {
+    uint32_t timeLeftUs = getPowerUpTimeLeftUs();
+    // delayMicroseconds() isn't accurate with long delays in some Arduino boards
+    if (timeLeftUs >= 1000)
+      hal::delayMs(timeLeftUs / 1000);
+    else
+      hal::delayUs(timeLeftUs);
   }
+}
 
-  using namespace ads::registers;
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::beginAsync() {
+  // Take a free slot of the registry
+  if (registrySlot != _ADS_NO_REGISTRY_SLOT)
+    _ADS_ERROR("begin() was already called. You must call end() method before calling begin() again");
+  for (uint8_t i = 0; i < ADS_MAX_SENSORS && registrySlot == _ADS_NO_REGISTRY_SLOT; i++) {
+    if (_ADS129xSensorPrivateInstances_[i] == NULL) {
+      _ADS129xSensorPrivateInstances_[i] = this;
+      registrySlot = i;
+#if ADS_ASYNC_FRAME_READ
+      _ADS129xSensorPrivateDeferredDrdys_[i] = _ads_slot_isrs_t<ADS129xChipSensor>::runDeferredDrdy[i];
+#endif
+    }
+  }
+  if (registrySlot == _ADS_NO_REGISTRY_SLOT)
+    _ADS_ERROR("The library allows only ADS_MAX_SENSORS sensor objects to be inicialized. You must call end() method in another sensor or increase ADS_MAX_SENSORS");
 
   // start the SPI library:
-  SPI.begin();
+  hal::spiBegin();
 
   // Mandatory pins configuration
   // Chip select pin configuration
-  pinMode(this->chipSelectPin, OUTPUT);
-  digitalWrite(this->chipSelectPin, HIGH);
+  hal::setPinAsOutput(this->chipSelectPin);
+  hal::writePin(this->chipSelectPin, HIGH);
 
   // DRDY (data ready) pin configuration
-  pinMode(drdyPin, INPUT);
-  // DRDY pin used to interrupt is attached to the Arduino
-  attachInterrupt(digitalPinToInterrupt(drdyPin), _ISR_ADS_privateReadDataFromChip_, FALLING);
-  SPI.usingInterrupt(digitalPinToInterrupt(drdyPin)); // Disable the interrupt when there is a SPI transaction in course
+  hal::setPinAsInput(drdyPin);
+  // DRDY pin used to interrupt is attached to the Arduino. The interrupt is disabled when there is a SPI transaction in course
+  hal::attachDrdyInterrupt(drdyPin, _ads_slot_isrs_t<ADS129xChipSensor>::readDataFromChip[registrySlot]);
 
   // ADS configuration
   // See page 85 in the datashhet for more information about ADS129XX boot up sequency.
   // See page page 84, 10.1.1 Setting the Device for Basic Data Capture, in the datasheet
   // Starting power-up sequency
 #if ADS_LIBRARY_VERBOSE_LEVEL > 0
-  Serial.println("Starting power-up sequency");
+  hal::println("Starting power-up sequency");
 #endif
-  // We wait _ADS_POWER_UP_DELAY_MS miliseconds before sent any command to ADS12XX
+  // We wait powerUpDelayMs miliseconds before sent any command to ADS12XX
   // Also, we Wait for t_por and VCAP1 > 1.1V
   // Moreover, give to to the internal oscillator to start up (it is 20 microseconds (see electrical characteristics in the datasheet)
-  delay(_ADS_POWER_UP_DELAY_MS);
-
-  // Set CLKSEL, START and PDWN pins to default value if are provided by user specified in
-  // page 84, 10.1.1 Setting the Device for Basic Data Capture, in the datasheet
-  // I also configure the arduino pins connected to them
+  powerUpState = _ADS_POWER_UP_WAITING_SUPPLY;
+  setPowerUpWait((uint32_t) powerUpDelayMs * 1000);
+}
 
-  // If clksel pin is specified, external clock is provided to ADS chip.
-  if (clkselPin != ADS_PIN_NOT_USED) {
-    pinMode(this->clkselPin, OUTPUT);
-    enableExternalClockSource();
+template <uint8_t chip, uint8_t bits>
+boolean ADS129xChipSensor<chip, bits>::poll() {
+  // Every step is done as soon as the wait of the previous one has finished, so several steps can be done in one call
+  if (powerUpState == _ADS_POWER_UP_WAITING_SUPPLY && getPowerUpTimeLeftUs() == 0) {
+    // Set CLKSEL, START and PDWN pins to default value if are provided by user specified in
+    // page 84, 10.1.1 Setting the Device for Basic Data Capture, in the datasheet
+    // I also configure the arduino pins connected to them
+
+    // If clksel pin is specified, external clock is provided to ADS chip.
+    if (clkselPin != ADS_PIN_NOT_USED) {
+      hal::setPinAsOutput(this->clkselPin);
+      enableExternalClockSource();
+    }
+
+    // Start pin
+    if (startPin != ADS_PIN_NOT_USED) {
+      hal::setPinAsOutput(this->startPin);
+      disableHardwareStartMode();
+    }
+
+    // Pdwn Pin. The wake-up of the internal reference (see disableHardwarePowerDownMode()) is the wait of this step
+    if (pwdnPin != ADS_PIN_NOT_USED) {
+      hal::setPinAsOutput(this->pwdnPin);
+      hal::writePin(this->pwdnPin, HIGH);
+    }
+
+    // Reset pin
+    if (resetPin != ADS_PIN_NOT_USED) {
+      hal::setPinAsOutput(this->resetPin);
+      hal::writePin(this->resetPin, HIGH);
+    }
+
+    powerUpState = _ADS_POWER_UP_WAITING_PINS;
+    setPowerUpWait(pwdnPin != ADS_PIN_NOT_USED ? _ADS_PWDN_WAKE_UP_US : 0);
   }
 
-  // Start pin
-  if (startPin != ADS_PIN_NOT_USED) {
-    pinMode(this->startPin, OUTPUT);
-    disableHardwareStartMode();
-  }
+  if (powerUpState == _ADS_POWER_UP_WAITING_PINS && getPowerUpTimeLeftUs() == 0)
+    startReset();
 
-  // Pdwn Pin
-  if (pwdnPin != ADS_PIN_NOT_USED) {
-    pinMode(this->pwdnPin, OUTPUT);
-    disableHardwarePowerDownMode();
+  if (powerUpState == _ADS_POWER_UP_WAITING_RESET_PULSE && getPowerUpTimeLeftUs() == 0) {
+    hal::writePin(this->resetPin, HIGH);
+    // 18 t_CLK before the first command. See page 48, section 9.3.2.3 Reset (RESET Pin and Reset Command), in the datasheet
+    powerUpState = _ADS_POWER_UP_WAITING_RESET;
+    setPowerUpWait((uint32_t) _ADS_T_CLK_18);
   }
 
-  // Reset pin
-  if (resetPin != ADS_PIN_NOT_USED) {
-    pinMode(this->resetPin, OUTPUT);
-    digitalWrite(this->resetPin, HIGH);
-  }
+  if (powerUpState == _ADS_POWER_UP_WAITING_RESET && getPowerUpTimeLeftUs() == 0) {
+    using namespace ads::registers;
 
-  // Reset ADS by hardware or software reset. It is indifferent. Hardware reset is the prefered method
-  resetADS();
-  // Stop RDATAC mode (ads129x restart by default in this configuration). See page 62, section 9.5.2.6 RDATAC: Read Data Continuous, in the datasheet
-  sendSPICommandSDATAC(false);
-
-  // Checking that ADS is the right model
-  byte idRegister = readRegister(id::REG_ADDR);
-  uint8_t correctIdChip = 0;
-  switch (ADS_CHIP_USED) {
-    case ADS_1294: correctIdChip = id::ID_ADS1294;   break;
-    case ADS_1294R: correctIdChip = id::ID_ADS1294R;   break;
-    case ADS_1296: correctIdChip = id::ID_ADS1296;   break;
-    case ADS_1296R: correctIdChip = id::ID_ADS1296R;   break;
-    case ADS_1298: correctIdChip = id::ID_ADS1298;   break;
-    case ADS_1298R: correctIdChip = id::ID_ADS1298R;   break;
-  }
+    // Stop RDATAC mode (ads129x restart by default in this configuration). See page 62, section 9.5.2.6 RDATAC: Read Data Continuous, in the datasheet
+    sendSPICommandSDATAC(false);
 
-  if (idRegister != correctIdChip)
-    _ADS_ERROR("ID reported from ADS chip and the chip model configurated by user are not the same => Theorical y real ADS models are not the same !!!!!");
+    // Checking that ADS is the right model
+    byte idRegister = readRegister(id::REG_ADDR);
+    if (idRegister != ads::chip_traits<chip>::ID)
+      _ADS_ERROR("ID reported from ADS chip and the chip model configurated by user are not the same => Theorical y real ADS models are not the same !!!!!");
 
-  // Power up sequency completed
+    powerUpState = _ADS_POWER_UP_IDLE;
+    // Power up sequency completed
 #if ADS_LIBRARY_VERBOSE_LEVEL > 0
-  Serial.println("Power-up sequency completed");
+    hal::println("Power-up sequency completed");
 #endif
+  }
+
+  return powerUpState == _ADS_POWER_UP_IDLE;
+}
+
+template <uint8_t chip, uint8_t bits>
+uint32_t ADS129xChipSensor<chip, bits>::getPowerUpTimeLeftUs() {
+  if (powerUpState == _ADS_POWER_UP_IDLE)
+    return 0;
+  // The difference is signed, so the deadline works when micros() wraps around
+  int32_t timeLeftUs = (int32_t)(powerUpDeadlineUs - hal::micros());
+  return timeLeftUs > 0 ? timeLeftUs : 0;
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::resetAsync() {
+  if (registrySlot == _ADS_NO_REGISTRY_SLOT)
+    _ADS_ERROR("begin() wasn't called");
+  startReset();
 }
 
-void ADS129xSensor::end() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::end() {
+  // begin() wasn't called (or end() was already called) -> there is no slot to give back
+  if (registrySlot == _ADS_NO_REGISTRY_SLOT)
+    return;
   sendSPICommandSDATAC(true);
   sendSPICommandSTOP(true);
-  _ADS129xSensorPrivateInstance_ = NULL;
+  endSpiTransaction();
+  hal::detachDrdyInterrupt(drdyPin);
+#if ADS_ASYNC_FRAME_READ
+  isDrdyDeferred = false;
+  _ADS129xSensorPrivateDeferredDrdys_[registrySlot] = NULL;
+#endif
+  _ADS129xSensorPrivateInstances_[registrySlot] = NULL;
+  registrySlot = _ADS_NO_REGISTRY_SLOT;
+  powerUpState = _ADS_POWER_UP_IDLE;
 }
 
-void ADS129xSensor::resetADS() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::startReset() {
   // FIXME: en estos comentarios, la construcción con "prefer" es correcta??
   // Hardware reset is prefered over software reset.
   if (resetPin == ADS_PIN_NOT_USED) {
@@ -144,159 +273,533 @@ void ADS129xSensor::resetADS() {
     //       However, if I used it and in some piece of code has a bug, chip could be not reseted. So, I prefer to
     //       make sure that chip ALWAYS is reseted.
     sendSPICommandSDATAC(true);
-    sendSPICommandRESET(true);
+    // sendSPICommandRESET() would wait the 18 t_CLK of the reset -> it's the wait of the next step
+    sendCommand(ads::commands::RESET);
+    powerUpState = _ADS_POWER_UP_WAITING_RESET;
+    setPowerUpWait((uint32_t) _ADS_T_CLK_18);
   } else {
-    // Hardware reset is performed
-    // No need for more worries ;)
-    doHardwareReset();
+    // Hardware reset is performed. The pulse is finished by poll() (see doHardwareReset())
+    hal::writePin(this->resetPin, LOW);
+    powerUpState = _ADS_POWER_UP_WAITING_RESET_PULSE;
+    setPowerUpWait((uint32_t) _ADS_T_CLK_2);
   }
   // Remember that ADS12XX enters in read data continuous mode (RDATAC) after reset command. See page 62, section 9.5.2.6 RDATAC: Read Data Continuous, in the datasheet
   readingStatus = _ADS_READING_DATA_IN_RDATAC_MODE;
+  setRegisterShadowToResetValues();
+  restartDrdyTracking();
 }
+// See page 65, section 9.6 Register Map, in the datasheet
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::setRegisterShadowToResetValues() {
+  using namespace ads::registers;
+
+  registerShadow[id::REG_ADDR] = ads::chip_traits<chip>::ID;
+  registerShadow[config1::REG_ADDR] = config1::RESET_VALUE;
+  registerShadow[config2::REG_ADDR] = config2::RESET_VALUE;
+  registerShadow[config3::REG_ADDR] = config3::RESET_VALUE;
+  registerShadow[loff::REG_ADDR] = loff::RESET_VALUE;
+  for (uint8_t i = 1; i <= 8; i++)
+    registerShadow[chnSet::_BASE_REG_ADDR + i] = chnSet::RESET_VALUE;
+  registerShadow[rldSensp::REG_ADDR] = rldSensp::RESET_VALUE;
+  registerShadow[rldSensn::REG_ADDR] = rldSensn::RESET_VALUE;
+  registerShadow[loffSensp::REG_ADDR] = loffSensp::RESET_VALUE;
+  registerShadow[loffSensn::REG_ADDR] = loffSensn::RESET_VALUE;
+  registerShadow[loffFlip::REG_ADDR] = loffFlip::RESET_VALUE;
+  registerShadow[loffStatp::REG_ADDR] = 0x00;
+  registerShadow[loffStatn::REG_ADDR] = 0x00;
+  registerShadow[gpio::REG_ADDR] = gpio::RESET_VALUE;
+  registerShadow[pace::REG_ADDR] = pace::RESET_VALUE;
+  registerShadow[resp::REG_ADDR] = resp::RESET_VALUE;
+  registerShadow[config4::REG_ADDR] = config4::RESET_VALUE;
+  registerShadow[wct1::REG_ADDR] = wct1::RESET_VALUE;
+  registerShadow[wct2::REG_ADDR] = wct2::RESET_VALUE;
+  dirtyRegisters = 0;
+}
+
+#if ADS_ISR_INSTRUMENTATION
+// Add a time to its logarithmic bucket (see ads_histogram_t)
+static void _addToHistogram(ads_histogram_t *histogram, uint32_t us) {
+  uint8_t bucket = 0;
+  for (uint32_t v = us; v != 0 && bucket < ADS_HISTOGRAM_BUCKETS - 1; v >>= 1)
+    bucket++;
+  histogram->buckets[bucket]++;
+  if (us > histogram->maxUs)
+    histogram->maxUs = us;
+}
+#endif
 
 // Interruption won't be called if SPI is in use
-void ADS129xSensor::_privateReadDataFromChip_() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::_privateReadDataFromChip_() {
+  uint32_t entryUs = hal::micros();
+#if ADS_ASYNC_FRAME_READ
+  // The SPI bus is busy with the asynchronous read of a frame (of this or another sensor). Waiting for it here would
+  // block the interruption that finishes it -> the end of the read calls this interruption again
+  if (_asyncFrameReadInFlight) {
+    deferredDrdyUs = entryUs;
+    isDrdyDeferred = true;
+    return;
+  }
+#endif
+  readDataFromChip(entryUs);
+#if ADS_ISR_INSTRUMENTATION
+  _addToHistogram(&isrStats.isr, hal::micros() - entryUs);
+#endif
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::readDataFromChip(uint32_t entryUs) {
+  uint32_t nowUs = entryUs;
+  // Edges since the last call. More than one if the interruption was masked by a SPI transaction. The division is
+  // only done in that case (it's slow in AVR boards). Times in quarters of microsecond: all the DRDY periods are exact
+  uint32_t nEdges = 1;
+  if (isLastDrdyValid) {
+    uint32_t elapsedQus = (nowUs - lastDrdyUs) * 4;
+    if (elapsedQus >= drdyPeriodQus + drdyPeriodQus / 2)
+      nEdges = (elapsedQus + drdyPeriodQus / 16) / drdyPeriodQus; // Tolerance for the interruption latency
+    // The call was delayed -> the edge time is estimated. Otherwise, the edge time is taken again (ADS and
+    // microcontroller clocks drift)
+    if ((int32_t)(elapsedQus - nEdges * drdyPeriodQus) > (int32_t)(drdyPeriodQus / 8))
+      nowUs = lastDrdyUs + nEdges * drdyPeriodQus / 4;
+  }
+  lastDrdyUs = nowUs;
+  isLastDrdyValid = true;
+  drdyEdgeCount = drdyEdgeCount + nEdges;
+
   if (readingStatus == _ADS_NO_READING_NEW_DATA)
     return; // It is not needed to read the new available data
-  else if (readingStatus == _ADS_READING_DATA_IN_RDATAC_MODE)
-    beginSpiTransaction();
+
+  edgesWhileSpiOpenCount = edgesWhileSpiOpenCount + (nEdges - 1);
+
+  // Ring buffer is full -> drop the new frame. Only the consumer can free slots. In RDATA mode, the sample
+  // is read in the next DRDY after the consumer frees a slot.
+  if ((_ads_frame_index_t)(frameHead - frameTail) >= ADS_FRAME_BUFFER_SIZE) {
+    overrunCount++;
+    return;
+  }
+
+  ads_frame_info_t *info = &frameInfo[frameHead & _ADS_FRAME_BUFFER_MASK];
+  info->sampleIndex = drdyEdgeCount - 1;
+  info->timestampUs = nowUs;
+#if ADS_RUNTIME_FRAME_WIDTH
+  info->bitsPerChannel = frameBits;
+#endif
+  uint8_t nBytes = getFrameSize();
+
+#if ADS_ISR_INSTRUMENTATION
+  isIsrTransaction = true; // Until endSpiTransaction()
+#endif
+#if ADS_ASYNC_FRAME_READ
+  // The bus belongs to the interruption from now until the frame is read (see beginSpiTransaction()). The transfer can
+  // finish before spiTransferAsync() returns, so it must be marked before it starts too
+  _asyncFrameReadInFlight = true;
+#endif
+  // Frames in RDATAC mode don't need any command -> they can be read faster than commands
+  if (readingStatus == _ADS_READING_DATA_IN_RDATAC_MODE)
+    beginSpiTransaction(ADS_SPI_FRAME_READ_SPEED);
   else {
     sendCommand(ads::commands::RDATA, true); // Leave open SPI transaction
     // Only one sample need to be read -> later sample must be ignored
     readingStatus = _ADS_NO_READING_NEW_DATA;
   }
+#if ADS_ISR_INSTRUMENTATION
+  _addToHistogram(&isrStats.drdyToCsLow, spiOpenUs - nowUs); // nowUs is the time of the edge
+  countSpiBytes(nBytes);
+#endif
+
+  // The frame is written directly in its slot of the ring buffer
+  byte *buffer = frameBuffer[frameHead & _ADS_FRAME_BUFFER_MASK].rawData;
 
-  // Cleaning the SPI buffer
-  for (uint8_t i = 0; i < _ADS_DATA_PACKAGE_SIZE; i++)
-    adsData.rawData[i] = 0x00;
+#if ADS_ASYNC_FRAME_READ
+  if (hal::spiTransferAsync(buffer, nBytes, _ads_slot_isrs_t<ADS129xChipSensor>::frameReadCompleted[registrySlot]))
+    return; // _privateFrameReadCompleted_() publishes the frame
+  _asyncFrameReadInFlight = false; // Not supported by the backend -> synchronous fallback
+#endif
 
-  void *buffer = (void*) &adsData.rawData;
-  SPI.transfer(buffer, _ADS_DATA_PACKAGE_SIZE);
+  // DIN must be LOW while the frame is read. spiReceive() sends zeros, so the slot doesn't need to be cleared first
+  hal::spiReceive(buffer, nBytes);
+  _privateFrameReadCompleted_();
+}
 
-  hasNewData = true;
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::_privateFrameReadCompleted_() {
   endSpiTransaction();
+
+#if ADS_STATUS_EVENT_BUFFER_SIZE > 0
+  _ads_frame_index_t slot = frameHead & _ADS_FRAME_BUFFER_MASK;
+  trackStatusWords(&frameBuffer[slot], frameInfo[slot].sampleIndex);
+#endif
+
+  // Publish the frame. It must be completely written before the consumer can see it
+  _ADS_MEMORY_BARRIER();
+  frameHead = frameHead + 1;
+  framesStoredCount = framesStoredCount + 1;
+  _asyncFrameReadInFlight = false;
+#if ADS_ASYNC_FRAME_READ
+  _runDeferredDrdys();
+#endif
+}
+
+#if ADS_ASYNC_FRAME_READ
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::_privateRunDeferredDrdy_() {
+  if (!isDrdyDeferred)
+    return;
+  isDrdyDeferred = false;
+  // The edge was at the time of the deferred call
+  readDataFromChip(deferredDrdyUs);
+}
+#endif
+
+/* ====== Ring buffer methods ========== */
+template <uint8_t chip, uint8_t bits>
+typename ADS129xChipSensor<chip, bits>::data_t * ADS129xChipSensor<chip, bits>::getData() {
+  data_t *frame = peek();
+  if (frame != NULL) {
+    adsData = *frame;
+    adsDataInfo = *peekInfo();
+    pop();
+  }
+  return &adsData;
+}
+
+template <uint8_t chip, uint8_t bits>
+uint16_t ADS129xChipSensor<chip, bits>::availableContiguous() {
+  uint16_t nAvailable = available();
+  uint16_t untilEnd = ADS_FRAME_BUFFER_SIZE - (frameTail & _ADS_FRAME_BUFFER_MASK);
+  return nAvailable < untilEnd ? nAvailable : untilEnd;
+}
+
+template <uint8_t chip, uint8_t bits>
+typename ADS129xChipSensor<chip, bits>::data_t * ADS129xChipSensor<chip, bits>::peek(uint16_t index) {
+  if (index >= available())
+    return NULL;
+  return &frameBuffer[(_ads_frame_index_t)(frameTail + index) & _ADS_FRAME_BUFFER_MASK];
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::pop(uint16_t nFrames) {
+  uint16_t nAvailable = available();
+  if (nFrames > nAvailable)
+    nFrames = nAvailable;
+
+  // The consumer must finish to read the frames before their slots are given back to the interruption
+  _ADS_MEMORY_BARRIER();
+  frameTail = frameTail + nFrames;
+}
+
+template <uint8_t chip, uint8_t bits>
+uint32_t ADS129xChipSensor<chip, bits>::getOverrunCount() {
+  // 32 bits variables can't be read atomically in AVR boards
+  hal::disableInterrupts();
+  uint32_t count = overrunCount;
+  hal::enableInterrupts();
+  return count;
+}
+
+template <uint8_t chip, uint8_t bits>
+uint16_t ADS129xChipSensor<chip, bits>::acquireFrames(frame_span_t *span, uint16_t maxFrames) {
+  // available() is read once, so the span doesn't change if the interruption adds frames meanwhile
+  uint16_t nFrames = availableContiguous();
+  if (nFrames > maxFrames)
+    nFrames = maxFrames;
+
+  _ads_frame_index_t slot = frameTail & _ADS_FRAME_BUFFER_MASK;
+#if ADS_RUNTIME_FRAME_WIDTH
+  // The span ends at the first frame with other bits per channel (the data rate was changed)
+  for (uint16_t i = 1; i < nFrames; i++) {
+    if (frameInfo[slot + i].bitsPerChannel != frameInfo[slot].bitsPerChannel) {
+      nFrames = i;
+      break;
+    }
+  }
+#endif
+  span->frames = &frameBuffer[slot];
+  span->info = &frameInfo[slot];
+  span->nFrames = nFrames;
+  return nFrames;
+}
+
+template <uint8_t chip, uint8_t bits>
+ads_frame_info_t * ADS129xChipSensor<chip, bits>::peekInfo(uint16_t index) {
+  if (index >= available())
+    return NULL;
+  return &frameInfo[(_ads_frame_index_t)(frameTail + index) & _ADS_FRAME_BUFFER_MASK];
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::getFrameCounters(ads_frame_counters_t *counters) {
+  // All the counters are read in the same interruption-free section -> they are consistent
+  hal::disableInterrupts();
+  counters->drdyEdges = drdyEdgeCount;
+  counters->framesStored = framesStoredCount;
+  counters->framesDropped = overrunCount;
+  counters->edgesWhileSpiOpen = edgesWhileSpiOpenCount;
+  hal::enableInterrupts();
+}
+
+#if ADS_ISR_INSTRUMENTATION
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::getIsrStats(ads_isr_stats_t *stats) {
+  // The interruption can't change the measures while they are copied
+  hal::disableInterrupts();
+  *stats = isrStats;
+  hal::enableInterrupts();
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::resetIsrStats() {
+  hal::disableInterrupts();
+  isrStats = ads_isr_stats_t();
+  hal::enableInterrupts();
+}
+#endif
+
+#if ADS_STATUS_EVENT_BUFFER_SIZE > 0
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::trackStatusWords(const data_t *frame, uint32_t sampleIndex) {
+  for (uint8_t d = 0; d < ADS_DAISY_CHAIN_DEVICES; d++) {
+#if ADS_RUNTIME_FRAME_WIDTH
+    // The devices of 16 bits frames are closer than the ones of data_t
+    const byte *statusWord = frame->rawData + d * (getFrameSize() / ADS_DAISY_CHAIN_DEVICES);
+#else
+    const byte *statusWord = frame->device[d].statusWord;
+#endif
+    byte *last = lastStatusWord[d];
+    // Usual case: nothing changed -> only 3 comparisons
+    if (hasLastStatusWord[d] && statusWord[0] == last[0] && statusWord[1] == last[1] && statusWord[2] == last[2])
+      continue;
+    if (!ads::isStatusWordValid(statusWord))
+      continue;
+    // The buffer is full -> last status word isn't updated, so the change is stored in a next frame
+    if ((uint8_t)(statusEventHead - statusEventTail) >= ADS_STATUS_EVENT_BUFFER_SIZE)
+      return;
+
+    ads_status_event_t *event = &statusEvents[statusEventHead & _ADS_STATUS_EVENT_BUFFER_MASK];
+    event->sampleIndex = sampleIndex;
+    event->device = d;
+    event->status = ads::decodeStatusWord(statusWord);
+    if (hasLastStatusWord[d]) {
+      ads::status_t lastStatus = ads::decodeStatusWord(last);
+      event->changed.loffStatp = event->status.loffStatp ^ lastStatus.loffStatp;
+      event->changed.loffStatn = event->status.loffStatn ^ lastStatus.loffStatn;
+      event->changed.gpio = event->status.gpio ^ lastStatus.gpio;
+    } else {
+      event->changed.loffStatp = 0xFF;
+      event->changed.loffStatn = 0xFF;
+      event->changed.gpio = 0x0F;
+    }
+    last[0] = statusWord[0];
+    last[1] = statusWord[1];
+    last[2] = statusWord[2];
+    hasLastStatusWord[d] = true;
+
+    _ADS_MEMORY_BARRIER(); // The event must be written before the consumer can see it
+    statusEventHead = statusEventHead + 1;
+  }
+}
+
+template <uint8_t chip, uint8_t bits>
+boolean ADS129xChipSensor<chip, bits>::popStatusEvent(ads_status_event_t *event) {
+  if (availableStatusEvents() == 0)
+    return false;
+  *event = statusEvents[statusEventTail & _ADS_STATUS_EVENT_BUFFER_MASK];
+  _ADS_MEMORY_BARRIER(); // The event must be copied before its slot is given back to the interruption
+  statusEventTail = statusEventTail + 1;
+  return true;
+}
+#endif
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::restartDrdyTracking() {
+  uint32_t periodQus = 4000000UL / getDataRate();
+  hal::disableInterrupts();
+  drdyPeriodQus = periodQus;
+#if ADS_RUNTIME_FRAME_WIDTH
+  // No frame is being read: CONFIG1 can't be written in RDATAC mode
+  frameBits = ads::registers::config1::bitsPerChannel(registerShadow[ads::registers::config1::REG_ADDR]);
+  frameSize = frameSizeFor(frameBits);
+#endif
+  isLastDrdyValid = false;
+  hal::enableInterrupts();
+}
+
+/* ====== Daisy-chain methods ========== */
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::demultiplexFrame(const data_t *frame, daisy_frame_t *daisyFrame) {
+  for (uint8_t d = 0; d < ADS_DAISY_CHAIN_DEVICES; d++) {
+    const device_data_t *device = &frame->device[d];
+    for (uint8_t i = 0; i < 3; i++)
+      daisyFrame->statusWord[d][i] = device->statusWord[i];
+    for (uint8_t i = 0; i < N_CHANNELS; i++)
+      daisyFrame->channel[d * N_CHANNELS + i] = device->channel[i];
+  }
 }
 
 /* ====== Methods that use hardware pins ========== */
-void ADS129xSensor::doHardwareReset() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::doHardwareReset() {
   if (resetPin == ADS_PIN_NOT_USED)
     _ADS_ERROR("Reset pin is not specified!!!");
 
-  digitalWrite(this->resetPin, LOW);
-  delay(_ADS_T_CLK_2);
-  digitalWrite(this->resetPin, HIGH);
+  hal::writePin(this->resetPin, LOW);
+  hal::delayUs(_ADS_T_CLK_2);
+  hal::writePin(this->resetPin, HIGH);
+  // No command can be sent during 18 t_CLK. See page 48, section 9.3.2.3 Reset (RESET Pin and Reset Command), in the datasheet
+  hal::delayUs(_ADS_T_CLK_18);
 }
 
-void ADS129xSensor::enableHardwareStartMode() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::enableHardwareStartMode() {
   if (startPin == ADS_PIN_NOT_USED)
     _ADS_ERROR("Start pin is not specified!!!");
 
   // See page 51, section 9.4.1.1 Start mode, in the datasheet for more information
-  digitalWrite(startPin, HIGH);
-  delay(_ADS_T_CLK_2);
+  hal::writePin(startPin, HIGH);
+  hal::delayUs(_ADS_T_CLK_2);
+  restartDrdyTracking();
 }
 
-void ADS129xSensor::disableHardwareStartMode() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::disableHardwareStartMode() {
   if (startPin == ADS_PIN_NOT_USED)
     _ADS_ERROR("Start pin is not specified!!!");
 
   // See page 51, section 9.4.1.1 Start mode, in the datasheet for more information
-  digitalWrite(startPin, LOW);
-  delay(_ADS_T_CLK_2);
+  hal::writePin(startPin, LOW);
+  hal::delayUs(_ADS_T_CLK_2);
 }
 
-void ADS129xSensor::enableExternalClockSource() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::enableExternalClockSource() {
   if (clkselPin == ADS_PIN_NOT_USED)
     _ADS_ERROR("Clksel pin is not specified!!!");
 
   // See page 5, section 9.3.2.5 Clock, in the datasheet for more information
-  digitalWrite(clkselPin, LOW);
+  hal::writePin(clkselPin, LOW);
 }
 
-void ADS129xSensor::disableExternalClockSource() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::disableExternalClockSource() {
   if (clkselPin == ADS_PIN_NOT_USED)
     _ADS_ERROR("Clksel pin is not specified!!!");
 
   // See page 5, section 9.3.2.5 Clock, in the datasheet for more information
-  digitalWrite(clkselPin, HIGH);
+  hal::writePin(clkselPin, HIGH);
   // Wait for internal clock power up. See page 15, Elecrical Characteristics, in the datasheet
-  delayMicroseconds(20);
+  hal::delayUs(20);
 }
 
 // Only it can be used if pwdn pin is specified
-void ADS129xSensor::enableHardwarePowerDownMode() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::enableHardwarePowerDownMode() {
   if (pwdnPin == ADS_PIN_NOT_USED)
     _ADS_ERROR("PWDN pin is not specified!!!");
 
   // See page 48, section 9.3.2.2 Power-Down Pin (PWDN) in the datasheet for more details about powerup after a power down.
-  digitalWrite(this->pwdnPin, LOW);
+  hal::writePin(this->pwdnPin, LOW);
 }
 // Only it can be used if pwdn pin is specified
-void ADS129xSensor::disableHardwarePowerDownMode() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::disableHardwarePowerDownMode() {
   if (pwdnPin == ADS_PIN_NOT_USED)
     _ADS_ERROR("PWDN pin is not specified!!!");
 
   // See page 48, section 9.3.2.2 Power-Down Pin (PWDN) in the datasheet for more details about powerup after a power down.
-  digitalWrite(this->pwdnPin, HIGH);
+  hal::writePin(this->pwdnPin, HIGH);
   // Upon exiting from power-down mode, the internal oscillator and the reference require time to wakeup.
   // Wake up time for the oscillator is 20 microseconds. See page 15, section Electrical Characteristicsm - Clock, in the datasheet
   // Wake up time for the internal reference is 150 microseconds. See page 15, section Electrical Characteristicsm - Internal Reference, in the datasheet
-  delayMicroseconds(150); // I assume the worst case escenario -> wait for internal reference.
+  hal::delayUs(150); // I assume the worst case escenario -> wait for internal reference.
 }
 
 // See page 17, section 7.7 Switching Characteristics: Serial Interface, and page 59, section 9.5 Programming, in the datasheet) to understand SPI communication
-void ADS129xSensor::beginSpiTransaction() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::beginSpiTransaction(uint32_t clockHz) {
+  // If the transaction of an asynchronous frame read (of any sensor, the SPI bus is shared) is still open,
+  // hal::spiBeginTransaction() waits until the frame is read. Only your code waits there: the DRDY interruption is
+  // deferred instead (see _privateReadDataFromChip_()). isSpiOpen is also true while the frame of this sensor is read,
+  // but that transaction is the interruption's one -> your code must wait for it too
   // Configure SPI communication
-  if (!this->isSpiOpen) {
-    // Delays aren0't need because Arduino is slow enough to execute beginTransaction and endTransaction functions
-    SPI.beginTransaction(SPISettings(_ADS_SPI_MAX_SPEED, _ADS_SPI_BIT_ORDER, _ADS_SPI_MODE));
-    digitalWrite(this->chipSelectPin, LOW);
-    // delayMicroseconds(_ADS_T_CSSC);
+  if (!this->isSpiOpen || _asyncFrameReadInFlight) {
+    hal::spiBeginTransaction(this->chipSelectPin, clockHz);
     this->isSpiOpen = true;
+#if ADS_ISR_INSTRUMENTATION
+    spiOpenUs = hal::micros();
+    if (isIsrTransaction)
+      isrStats.isrSpiTransactions++;
+    else
+      isrStats.spiTransactions++;
+#endif
   } // It is already opened !!!
 }
 
 // See page 17, section 7.7 Switching Characteristics: Serial Interface, and page 59, section 9.5 Programming, in the datasheet) to understand SPI communication
-void ADS129xSensor::endSpiTransaction() {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::endSpiTransaction() {
   if (this->isSpiOpen) {
+#if ADS_ISR_INSTRUMENTATION
+    // Measured before CS goes high: the DRDY interruption can be called just after it
+    _addToHistogram(isIsrTransaction ? &isrStats.isrCsLow : &isrStats.spiHold, hal::micros() - spiOpenUs);
+    isIsrTransaction = false;
+#endif
     isSpiOpen = false;
-    // Delays aren0't need because Arduino is slow enough to execute beginTransaction and endTransaction functions
-    // delayMicroseconds(_ADS_T_SCCS);
-    digitalWrite(this->chipSelectPin, HIGH);
-    // delayMicroseconds(_ADS_T_CSH);
-
-    SPI.endTransaction();
+    hal::spiEndTransaction(this->chipSelectPin);
   }
 }
 
 
 /* ============ Registers ============== */
+template <uint8_t chip, uint8_t bits>
+byte ADS129xChipSensor<chip, bits>::readRegister(byte registAddr, boolean keepSpiOpen) {
+  byte registerValue;
+  readRegisters(registAddr, 1, &registerValue, keepSpiOpen);
+  return registerValue;
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::writeRegister(byte registAddr, byte data, boolean keepSpiOpen) {
+  writeRegisters(registAddr, 1, &data, keepSpiOpen);
+}
+
 // See page 17, section 7.7 Switching Characteristics: Serial Interface, and page 59, section 9.5 Programming, in the datasheet) to understand SPI communication
-byte ADS129xSensor::readRegister(byte registAddr, boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::readRegisters(byte startAddr, uint8_t count, byte *buffer, boolean keepSpiOpen) {
+  if (count == 0 || startAddr + count > ads::registers::N_REGISTERS)
+    _ADS_ERROR("Registers out of the register map");
+
   if (readingStatus == _ADS_READING_DATA_IN_RDATAC_MODE){
     _ADS_WARNING("In RDATAC mode, ADS only accept SDATAC SPI command. Others commands (like read/write registers) will be ignored "); 
-    return 0xFF;
+    for (uint8_t i = 0; i < count; i++)
+      buffer[i] = 0xFF;
+    return;
   }
 
   // In datasheet is not specified but I think that chip select must be low for the entire command.
   // because in case of writting in a register, chip select must be low in the entire operation
   beginSpiTransaction();
 
-  // Send write regiter command y the first register that will be written
-  SPI.transfer(ads::commands::RREG | registAddr);
-  // Send the number the register that will be written minus 1. Ex: 1 register will be written -> 0
-  SPI.transfer(0x00);
-  // DIN must be LOW when data is read
-  byte registerValue = SPI.transfer(0x00);
+  // Send read regiter command y the first register that will be read, and the number the register that will be read
+  // minus 1. Ex: 1 register will be read -> 0
+  byte command[2] = {(byte) (ads::commands::RREG | startAddr), (byte) (count - 1)};
+  hal::spiWrite(command, 2);
+  countSpiBytes(2 + count);
+  // DIN must be LOW when data is read (spiReceive() sends zeros)
+  hal::spiReceive(buffer, count);
+
+  for (uint8_t i = 0; i < count; i++)
+    registerShadow[startAddr + i] = buffer[i];
 
   if (!keepSpiOpen)
     endSpiTransaction();
-
-  return registerValue;
 }
 
 // See page 17, section 7.7 Switching Characteristics: Serial Interface, and page 59, section 9.5 Programming, in the datasheet) to understand SPI communication
-void ADS129xSensor::writeRegister(byte registAddr, byte data, boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::writeRegisters(byte startAddr, uint8_t count, const byte *buffer, boolean keepSpiOpen) {
+  if (count == 0 || startAddr + count > ads::registers::N_REGISTERS)
+    _ADS_ERROR("Registers out of the register map");
+
   if (readingStatus == _ADS_READING_DATA_IN_RDATAC_MODE){
     _ADS_WARNING("In RDATAC mode, ADS only accept SDATAC SPI command. Others commands (like read/write registers) will be ignored "); 
     return;
@@ -305,68 +808,140 @@ void ADS129xSensor::writeRegister(byte registAddr, byte data, boolean keepSpiOpe
   // Chip select must be low for the entire command
   beginSpiTransaction();
 
-  // Send write regiter command y the first register that will be written
-  SPI.transfer(ads::commands::WREG | registAddr);
-  // Send the number the register that will be written minus 1. Ex: 1 register will be written -> 0x00
-  SPI.transfer(0x00);
-  // Write register
-  SPI.transfer(data);
+  // Send write regiter command y the first register that will be written, and the number the register that will be
+  // written minus 1. Ex: 1 register will be written -> 0x00
+  byte command[2] = {(byte) (ads::commands::WREG | startAddr), (byte) (count - 1)};
+  hal::spiWrite(command, 2);
+  countSpiBytes(2 + count);
+  // Write registers
+  hal::spiWrite(buffer, count);
+
+  // buffer can be the shadow itself (see flushRegisters())
+  for (uint8_t i = 0; i < count; i++) {
+    registerShadow[startAddr + i] = buffer[i];
+    dirtyRegisters &= ~((uint32_t) 1 << (startAddr + i));
+  }
 
   // When resp or config1 registers are written, internal reset is performed. See page 48, section 9.3.2.3 Reset (RESET Pin and Reset Command), in the datasheet
+  // One wait is enough although both registers are written in the same command
   using namespace ads::registers;
-  if (registAddr == config1::REG_ADDR || registAddr == resp::REG_ADDR)
-    delay(_ADS_T_CLK_18);
+  if ((startAddr <= config1::REG_ADDR && config1::REG_ADDR < startAddr + count) ||
+      (startAddr <= resp::REG_ADDR && resp::REG_ADDR < startAddr + count)) {
+    hal::delayUs(_ADS_T_CLK_18);
+    restartDrdyTracking(); // The conversions are restarted (with the new data rate)
+  }
 
   if (!keepSpiOpen)
     endSpiTransaction();
 }
 
-void ADS129xSensor::setAllRegisterToResetValuesWithoutResetCommand( boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::readAllRegisters(byte *buffer, boolean keepSpiOpen) {
+  readRegisters(ads::registers::id::REG_ADDR, ads::registers::N_REGISTERS, buffer, keepSpiOpen);
+}
+
+/* ============ Register shadow ============== */
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::setRegisterShadow(byte registAddr, byte value) {
   using namespace ads::registers;
 
-  // ID register is read only
-  writeRegister(config1::REG_ADDR, config1::RESET_VALUE | config1::RESERVED_BITS, true);
-  writeRegister(config2::REG_ADDR, config2::RESET_VALUE | config2::RESERVED_BITS, true);
-  writeRegister(config3::REG_ADDR, config3::RESET_VALUE | config3::RESERVED_BITS, true);
-  writeRegister(loff::REG_ADDR, loff::RESET_VALUE | loff::RESERVED_BITS, true);
+  if (registAddr >= N_REGISTERS || registAddr == id::REG_ADDR || registAddr == loffStatp::REG_ADDR || registAddr == loffStatn::REG_ADDR)
+    _ADS_ERROR("The register doesn't exist or it is read-only");
 
-  // Channels registers
-  for (uint8_t i = 0; i < ADS_N_CHANNELS; i++)
-    writeRegister(chnSet::_BASE_REG_ADDR + i, chnSet::RESET_VALUE | chnSet::RESERVED_BITS, true);
+  if (registerShadow[registAddr] != value) {
+    registerShadow[registAddr] = value;
+    dirtyRegisters |= (uint32_t) 1 << registAddr;
+  }
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::flushRegisters(boolean keepSpiOpen) {
+  // As few SPI bytes as possible and CONFIG1/RESP last (see ads129xWritePlan.h)
+  ads::plan::plan_t plan;
+  ads::plan::make(dirtyRegisters, plan);
+  for (uint8_t b = 0; b < plan.nBursts; b++) {
+    const ads::plan::burst_t &burst = plan.bursts[b];
+    writeRegisters(burst.startAddr, burst.count, &registerShadow[burst.startAddr], true);
+    // Registers aren't written in RDATAC mode -> they are still dirty
+    if (dirtyRegisters & ((uint32_t) 1 << burst.startAddr))
+      break;
+  }
+
+  if (!keepSpiOpen)
+    endSpiTransaction();
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::beginRegisterChanges() {
+  holdingRegisterChanges = true;
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::endRegisterChanges(boolean keepSpiOpen) {
+  holdingRegisterChanges = false;
+  flushRegisters(keepSpiOpen);
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::writeRegisterChanges(boolean keepSpiOpen) {
+  if (!holdingRegisterChanges)
+    flushRegisters(keepSpiOpen);
+}
 
-  writeRegister(rldSensp::REG_ADDR, rldSensp::RESET_VALUE | rldSensp::RESERVED_BITS, true);
-  writeRegister(rldSensn::REG_ADDR, rldSensn::RESET_VALUE | rldSensn::RESERVED_BITS, true);
-  writeRegister(loffSensp::REG_ADDR, loffSensp::RESET_VALUE | loffSensp::RESERVED_BITS, true);
-  writeRegister(loffSensn::REG_ADDR, loffSensn::RESET_VALUE | loffSensn::RESERVED_BITS, true);
-  writeRegister(loffFlip::REG_ADDR, loffFlip::RESET_VALUE | loffFlip::RESERVED_BITS, true);
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::setAllRegisterToResetValuesWithoutResetCommand( boolean keepSpiOpen) {
+  using namespace ads::registers;
 
-  // loff_statp and loff_statn are read-only registers
-  writeRegister(gpio::REG_ADDR, gpio::RESET_VALUE | gpio::RESERVED_BITS, true);
-  writeRegister(pace::REG_ADDR, pace::RESET_VALUE | pace::RESERVED_BITS, true);
-  writeRegister(resp::REG_ADDR, resp::RESET_VALUE | resp::RESERVED_BITS, true);
-  writeRegister(config4::REG_ADDR, config4::RESET_VALUE | config4::RESERVED_BITS, true);
-  writeRegister(wct1::REG_ADDR, wct1::RESET_VALUE | wct1::RESERVED_BITS, true);
-  writeRegister(wct2::REG_ADDR, wct2::RESET_VALUE | wct2::RESERVED_BITS, keepSpiOpen);
+  byte values[N_REGISTERS];
+  values[config1::REG_ADDR] = config1::RESET_VALUE | config1::RESERVED_BITS;
+  values[config2::REG_ADDR] = config2::RESET_VALUE | config2::RESERVED_BITS;
+  values[config3::REG_ADDR] = config3::RESET_VALUE | config3::RESERVED_BITS;
+  values[loff::REG_ADDR] = loff::RESET_VALUE | loff::RESERVED_BITS;
+
+  // Channels registers. All of them are in the register map although the chip has less than 8 channels
+  for (uint8_t i = 1; i <= 8; i++)
+    values[chnSet::_BASE_REG_ADDR + i] = chnSet::RESET_VALUE | chnSet::RESERVED_BITS;
+
+  values[rldSensp::REG_ADDR] = rldSensp::RESET_VALUE | rldSensp::RESERVED_BITS;
+  values[rldSensn::REG_ADDR] = rldSensn::RESET_VALUE | rldSensn::RESERVED_BITS;
+  values[loffSensp::REG_ADDR] = loffSensp::RESET_VALUE | loffSensp::RESERVED_BITS;
+  values[loffSensn::REG_ADDR] = loffSensn::RESET_VALUE | loffSensn::RESERVED_BITS;
+  values[loffFlip::REG_ADDR] = loffFlip::RESET_VALUE | loffFlip::RESERVED_BITS;
+
+  values[gpio::REG_ADDR] = gpio::RESET_VALUE | gpio::RESERVED_BITS;
+  values[pace::REG_ADDR] = pace::RESET_VALUE | pace::RESERVED_BITS;
+  values[resp::REG_ADDR] = resp::RESET_VALUE | resp::RESERVED_BITS;
+  values[config4::REG_ADDR] = config4::RESET_VALUE | config4::RESERVED_BITS;
+  values[wct1::REG_ADDR] = wct1::RESET_VALUE | wct1::RESERVED_BITS;
+  values[wct2::REG_ADDR] = wct2::RESET_VALUE | wct2::RESERVED_BITS;
+
+  // ID register is read only -> from CONFIG1 to LOFF_FLIP
+  writeRegisters(config1::REG_ADDR, loffFlip::REG_ADDR - config1::REG_ADDR + 1, &values[config1::REG_ADDR], true);
+  // loff_statp and loff_statn are read-only registers -> from GPIO to WCT2
+  writeRegisters(gpio::REG_ADDR, wct2::REG_ADDR - gpio::REG_ADDR + 1, &values[gpio::REG_ADDR], keepSpiOpen);
 }
 
 /* ============ Commands ============== */
 // See page 17, section 7.7 Switching Characteristics: Serial Interface, and page 59, section 9.5 Programming, in the datasheet) to understand SPI communication
-void ADS129xSensor::sendCommand(byte command, boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendCommand(byte command, boolean keepSpiOpen) {
   beginSpiTransaction();
 
   // Send command
-  byte aux = SPI.transfer(command);
+  hal::spiWrite(&command, 1);
+  countSpiBytes(1);
 
 #if ADS_LIBRARY_VERBOSE_LEVEL > 1
-  Serial.print("Command sent: ");
-  Serial.println(command, BIN);
+  hal::print("Command sent: ");
+  hal::println(command, 2);
 #endif
 
   if (!keepSpiOpen)
     endSpiTransaction();
 }
 
-void ADS129xSensor::sendSPICommandWAKEUP(boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendSPICommandWAKEUP(boolean keepSpiOpen) {
   if (readingStatus == _ADS_READING_DATA_IN_RDATAC_MODE){
     _ADS_WARNING("In RDATAC mode, ADS only accept SDATAC SPI command. Others commands will be ignored"); 
     return;
@@ -375,10 +950,11 @@ void ADS129xSensor::sendSPICommandWAKEUP(boolean keepSpiOpen) {
   //After execute WAKEUP command, the next command must wait for 4*_ADS_T_CLK cycles (see page 61 in the datasheet)
   // 4*_ADS_T_CLK is roughtly 2 microseconds
   sendCommand(ads::commands::WAKEUP, keepSpiOpen);
-  delayMicroseconds(_ADS_T_CLK_4);
+  hal::delayUs(_ADS_T_CLK_4);
 }
 
-void ADS129xSensor::sendSPICommandSTANDBY(boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendSPICommandSTANDBY(boolean keepSpiOpen) {
   if (readingStatus == _ADS_READING_DATA_IN_RDATAC_MODE){
     _ADS_WARNING("In RDATAC mode, ADS only accept SDATAC SPI command. Others commands will be ignored"); 
     return;
@@ -388,7 +964,8 @@ void ADS129xSensor::sendSPICommandSTANDBY(boolean keepSpiOpen) {
   // No wait time needed
 }
 
-void ADS129xSensor::sendSPICommandRESET(boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendSPICommandRESET(boolean keepSpiOpen) {
   if (resetPin != ADS_PIN_NOT_USED)
     _ADS_ERROR("Reset pin is specified!!!! Reset must be done with the reset pin -> use doHardwareReset() method!!!");
 
@@ -400,10 +977,11 @@ void ADS129xSensor::sendSPICommandRESET(boolean keepSpiOpen) {
   // 18*_ADS_T_CLK cycles are required to execute the RESET command. Do not send any commands during this time. (see page 62 in datasheet)
   // 18 *_ADS_T_CLK is roughtly 8.8 microseconds
   sendCommand(ads::commands::RESET, keepSpiOpen);
-  delayMicroseconds(_ADS_T_CLK_18);
+  hal::delayUs(_ADS_T_CLK_18);
 }
 
-void ADS129xSensor::sendSPICommandSTART(boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendSPICommandSTART(boolean keepSpiOpen) {
   if (startPin != ADS_PIN_NOT_USED)
     _ADS_ERROR("Start pin is specified -> start and stop are not allowed!!!");
 
@@ -415,10 +993,12 @@ void ADS129xSensor::sendSPICommandSTART(boolean keepSpiOpen) {
   //After execute START command, the next command must wait for 4*_ADS_T_CLK cycles (see page 62 in the datasheet)
   // 4*_ADS_T_CLK is roughtly 2 microseconds
   sendCommand(ads::commands::START, keepSpiOpen);
-  delayMicroseconds(_ADS_T_CLK_4); // Only is necesarry if just after is sent STOP command
+  hal::delayUs(_ADS_T_CLK_4); // Only is necesarry if just after is sent STOP command
+  restartDrdyTracking();
 }
 
-void ADS129xSensor::sendSPICommandSTOP(boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendSPICommandSTOP(boolean keepSpiOpen) {
   if (startPin != ADS_PIN_NOT_USED)
     _ADS_ERROR("Start pin is specified -> start and stop are not allowed!!!");
 
@@ -432,7 +1012,8 @@ void ADS129xSensor::sendSPICommandSTOP(boolean keepSpiOpen) {
 }
 
 // Be aware that when RDATAC command is sent, the any other command except SDATAC will be ignored
-void ADS129xSensor::sendSPICommandRDATAC(boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendSPICommandRDATAC(boolean keepSpiOpen) {
   if (readingStatus == _ADS_READING_DATA_IN_RDATAC_MODE) {
     _ADS_WARNING("In RDATAC mode, ADS only accept SDATAC SPI command. Others commands will be ignored");
     return;
@@ -441,19 +1022,41 @@ void ADS129xSensor::sendSPICommandRDATAC(boolean keepSpiOpen) {
   //After execute RDATAC command, the next command must wait for 4*_ADS_T_CLK cycles (see page 62 in the datasheet)
   // 4*_ADS_T_CLK is roughtly 2 microseconds
   sendCommand(ads::commands::RDATAC, keepSpiOpen);
-  delayMicroseconds(_ADS_T_CLK_4);
+  hal::delayUs(_ADS_T_CLK_4);
   readingStatus = _ADS_READING_DATA_IN_RDATAC_MODE;
+
+#if ADS_LIBRARY_VERBOSE_LEVEL > 0
+  if (ADS_SPI_FRAME_READ_SPEED < getMinimumFrameSpiSpeed()) {
+    hal::print("Warning: ADS_SPI_FRAME_READ_SPEED is too low for the current data rate. Minimum SPI speed (Hz): ");
+    hal::println(getMinimumFrameSpiSpeed(), 10);
+  }
+  // DAISY_EN = 1 selects multiple readback mode -> the other devices of the chain aren't read. See page 66, section 9.6.1.2 CONFIG1, in the datasheet
+  if (ADS_DAISY_CHAIN_DEVICES > 1 && (registerShadow[ads::registers::config1::REG_ADDR] & ads::registers::config1::B_DAISY_EN))
+    hal::println("Warning: ADS_DAISY_CHAIN_DEVICES > 1 but DAISY_EN bit is set in CONFIG1 (multiple readback mode)");
+#endif
 }
 
-void ADS129xSensor::sendSPICommandSDATAC(boolean keepSpiOpen) {
+// See page 59, section 9.5.1.2 Serial Clock (SCLK), in the datasheet
+template <uint8_t chip, uint8_t bits>
+uint32_t ADS129xChipSensor<chip, bits>::getMinimumFrameSpiSpeed() {
+  // In daisy-chain, the frames of all devices are read before the next DRDY
+  float nBits = ADS_DAISY_CHAIN_DEVICES * (getBitsPerChannel() * N_CHANNELS + 24);
+  // Time (in seconds) available to read the frame: sample period minus 8 ADS clocks
+  float availableTime = 1.0 / getDataRate() - 8 * _ADS_T_CLK * 1e-6;
+  return (uint32_t) ceil(nBits / availableTime);
+}
+
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendSPICommandSDATAC(boolean keepSpiOpen) {
   //Afterfreturn execute SDATAC command, the next command must wait for 4*_ADS_T_CLK cycles (see page 63 in the datasheet)
   // 4*_ADS_T_CLK is roughtly 2 microseconds
   sendCommand(ads::commands::SDATAC, keepSpiOpen);
-  delayMicroseconds(_ADS_T_CLK_4);
+  hal::delayUs(_ADS_T_CLK_4);
   readingStatus = _ADS_NO_READING_NEW_DATA;
 }
 
-void ADS129xSensor::sendSPICommandRDATA(boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::sendSPICommandRDATA(boolean keepSpiOpen) {
   if (readingStatus == _ADS_READING_DATA_IN_RDATAC_MODE) {
     _ADS_WARNING("In RDATAC mode, ADS only accept SDATAC SPI command. Others commands will be ignored");
     return;
@@ -462,50 +1065,85 @@ void ADS129xSensor::sendSPICommandRDATA(boolean keepSpiOpen) {
   // RDATA command will be send when new data is available
   readingStatus = _ADS_READING_DATA_IN_RDATA_MODE;
 #if ADS_LIBRARY_VERBOSE_LEVEL > 1
-  Serial.print("readingStatus: ");
-  Serial.println(readingStatus);
+  hal::print("readingStatus: ");
+  hal::println(readingStatus, 10);
 #endif
 }
 
 /* ======= Class methods class implementing typical ADS configurations  ============= */
-void ADS129xSensor::disableChannel(uint8_t nChannel, boolean setInputAsShorted, boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::disableChannel(uint8_t nChannel, boolean setInputAsShorted, boolean keepSpiOpen) {
+  if (nChannel == 0)
+    _ADS_ERROR("nChannel is zero");
+
+  if (nChannel > N_CHANNELS)
+    _ADS_ERROR("nChannel is bigger than the number of channels that has the chip ADS");
+
   using namespace ads::registers::chnSet;
   byte registerAddress = _BASE_REG_ADDR + nChannel;
-  byte registerValue = readRegister(registerAddress, true);
   // Power down the channel --> write 1 in bit 7
-  writeRegister(registerAddress, registerValue | B_PDn, keepSpiOpen);
+  byte registerValue = registerShadow[registerAddress] | B_PDn;
+  if (setInputAsShorted) {
+    byte mask = B_MUXn2 | B_MUXn1 | B_MUXn0;
+    registerValue = (registerValue & ~mask) | SHORTED;
+  }
+  setRegisterShadow(registerAddress, registerValue);
+  writeRegisterChanges(keepSpiOpen);
 }
 
-void ADS129xSensor::enableChannel(uint8_t nChannel, int8_t channelInput, boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::enableChannel(uint8_t nChannel, int8_t channelInput, boolean keepSpiOpen) {
   if (nChannel == 0)
     _ADS_ERROR("nChannel is zero");
 
-  if (nChannel > ADS_N_CHANNELS)
+  if (nChannel > N_CHANNELS)
     _ADS_ERROR("nChannel is bigger than the number of channels that has the chip ADS");
 
   using namespace ads::registers::chnSet;
   byte registerAddress = _BASE_REG_ADDR + nChannel;
-  byte registerValue = readRegister(registerAddress, true);
+  byte registerValue = registerShadow[registerAddress];
   if (channelInput != -1) {
     byte mask = B_MUXn2 | B_MUXn1 | B_MUXn0;
     registerValue = registerValue & ~mask; // Remove current channel input configuration
     registerValue = registerValue | (channelInput & mask); // Set the new channel input configuration
   }
   // Power up the channel --> write 0 in bit _PDn
-  writeRegister(registerAddress, registerValue & (~B_PDn), keepSpiOpen);
+  setRegisterShadow(registerAddress, registerValue & (~B_PDn));
+  writeRegisterChanges(keepSpiOpen);
 }
 
-void ADS129xSensor::enableChannelAndSetGain(uint8_t nChannel, byte channelGainConstant, int8_t channelInput, boolean keepSpiOpen) {
+template <uint8_t chip, uint8_t bits>
+void ADS129xChipSensor<chip, bits>::enableChannelAndSetGain(uint8_t nChannel, byte channelGainConstant, int8_t channelInput, boolean keepSpiOpen) {
+  if (nChannel == 0)
+    _ADS_ERROR("nChannel is zero");
+
+  if (nChannel > N_CHANNELS)
+    _ADS_ERROR("nChannel is bigger than the number of channels that has the chip ADS");
+
   using namespace ads::registers::chnSet;
   byte registerAddress = _BASE_REG_ADDR + nChannel;
-  byte registerValue = readRegister(registerAddress, true);
+  byte registerValue = registerShadow[registerAddress];
   // Set 0 the gain bits
   registerValue = registerValue & (~(B_GAINn0 | B_GAINn1 | B_GAINn2));
   // Set the channel gain
   registerValue = registerValue | channelGainConstant;
-  writeRegister(registerAddress, registerValue, true);
-  // Power up the channel
+  setRegisterShadow(registerAddress, registerValue);
+  // Power up the channel. The gain and the power up are written together
   enableChannel(nChannel, channelInput, keepSpiOpen);
 }
 
-
+/* ======= Sensors of every chip model  ============= */
+// The methods are defined in this file -> the sensors of all chip models are compiled here (the linker drops the ones
+// that your program doesn't use). With ADS_RUNTIME_FRAME_WIDTH, the frames of both widths use 24 bits slots
+#define _ADS_SENSORS_WITH_BITS(bits) \
+  template class ADS129xChipSensor<ADS_1294, bits>; \
+  template class ADS129xChipSensor<ADS_1294R, bits>; \
+  template class ADS129xChipSensor<ADS_1296, bits>; \
+  template class ADS129xChipSensor<ADS_1296R, bits>; \
+  template class ADS129xChipSensor<ADS_1298, bits>; \
+  template class ADS129xChipSensor<ADS_1298R, bits>;
+
+_ADS_SENSORS_WITH_BITS(24)
+#if !ADS_RUNTIME_FRAME_WIDTH
+_ADS_SENSORS_WITH_BITS(16)
+#endif
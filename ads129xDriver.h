@@ -6,6 +6,9 @@
 
     Constants present in the Datasheet and some helper constant to configure the registers in ADS chip are defined in ads129xDatashhetConstants.h
     Read the documentation in these file to know more about it.
+
+    SPI, pins, interrupts and time functions are called through the hardware abstraction layer defined in ads129xHal.h. The
+    driver can be compiled on a computer against the ADS chip simulator in extras/simulator (see ads129xChipSimulator.h).
     
     --------------------------------
 
@@ -15,12 +18,12 @@
     Typical usage (see adsDriverExample for an example):
       0- Configure the ADS to use, verbose level and bits per channel (is not the same than resolution) in ads129xDriverConfig
       1- Cal1 the constructor
-      2- Call begin method
+      2- Call begin method (or beginAsync and poll methods to do other things during the power-up waits)
       3- (Optional) Configure ADS with read/write register methods and related helper methods ({enable/disable}Channel, ...)
       4- Put in Start mode the ADS by sendSPICommandSTART or enableHardwareStartMode methods
       5- Put ADS in RDATA(read one new sample) or RDATAC (read continuously new sample) mode 
-      6- Check if new data is available with hasNewDataAvailable method
-      7- If so, recover the new data sent by ADS with getData method
+      6- Check if new data is available with hasNewDataAvailable or available methods
+      7- If so, recover the new data sent by ADS with getData method (or with peek and pop methods to avoid copies)
 
 
 
@@ -34,6 +37,10 @@
         } formatedData;
       } ads_data_t;
 
+      If ADS_DAISY_CHAIN_DEVICES > 1 (see ads129xDriverConfig.h), rawData has the data of all daisy-chained devices (first 
+      device first) and it can also be accessed with the device[ADS_DAISY_CHAIN_DEVICES] field (device[0] is formatedData).
+      demultiplexFrame() converts it in an ads_daisy_frame_t with the ADS_TOTAL_CHANNELS channels of all devices together.
+
       ads_bits_sample_t is also an enum that depends with the value of ADS_BITS_PER_CHANNEL constant selected by user (it is defined in ads129xDriverConfig.h)
 
       If ADS_BITS_PER_CHANNEL is 16, then:
@@ -48,11 +55,55 @@
             uint8_t hi, mid, low; // High, middle and low byte. It's equivalent to an int of 24 bits 
           } ads_bits_sample_t;
 
+      These types are aliases of the ads::frame_traits<ADS_CHIP_USED, ADS_BITS_PER_CHANNEL, ADS_DAISY_CHAIN_DEVICES> template
+      (see ads129xFrame.h). Use the template directly to handle the frames of other chip models in the same program.
+
+    ADS129xSensor is the ADS129xChipSensor<chip, bits> class template for ADS_CHIP_USED and ADS_BITS_PER_CHANNEL. To drive
+    chips of other models in the same program (for example, an ADS1294R and an ADS1298 in cascade configuration), declare
+    them with their model:
+
+        ADS129xChipSensor<ADS_1294R> respirationSensor(10, 6);
+        ADS129xChipSensor<ADS_1298> ecgSensor(9, 5);
+
+    Each one has the frame types of its model (ADS129xChipSensor<ADS_1298>::data_t, frame_span_t, ...) and the channel
+    checks, frame sizes and ID check of its model. The modules that take a sensor follow its model too: recording writers
+    (ADS129xChipRecordingWriter<chip, bits>, see ads129xRecording.h), profiles (ads129xProfile.h) and, in the host
+    simulator, ADS129xChipSimulator::setChipModel(). The rest of ads129xDriverConfig.h (ADS_DAISY_CHAIN_DEVICES,
+    ADS_FRAME_BUFFER_SIZE, ADS_MAX_SENSORS, ...) is shared by all of them.
+
+    Limitation: the register constants of ads129xDatasheetConstants.h are defined only for ADS_CHIP_USED. The constants of
+    channels 5 to 8 (CH5SET to CH8SET, their bits in RLD_SENSP, WCT1, ...) exist only if it has them, the ones of the
+    respiration module only if it's an R model and the CONFIG1 data rates are the ones of ADS_BITS_PER_CHANNEL. A sensor of
+    another model must write the registers that need the missing constants with their addresses and values of the
+    datasheet (see writeRegister()).
+
           
 
-    The main limitation of this library is that doesn't implement any buffer for data sent by ADS chip. So, if you don't call 
-    getData and copy the data to another memory location, the next data retrieval from ADS will overwrite he old. See Limitations 
-    section to know about the other few limitations that has the library.
+    If ADS_ASYNC_FRAME_READ is 1 and the HAL backend supports it, the DRDY interruption only starts an asynchronous transfer
+    of the frame and the frame is added to the ring buffer when the transfer finishes. Meanwhile, the SPI transaction stays 
+    open and any other method that uses SPI waits for the transfer to finish. A DRDY interruption (of any sensor) that
+    comes meanwhile doesn't wait: it's deferred and the end of the transfer calls it.
+
+    Frames sent by ADS chip are stored by the DRDY interruption in a ring buffer of ADS_FRAME_BUFFER_SIZE frames (it's defined in
+    ads129xDriverConfig.h). The interruption is the only producer and your code is the only consumer, so no locks are needed:
+      - available() returns how many frames are waiting to be read.
+      - peek(i) returns a pointer to the i-th oldest frame without removing it. The frame stays untouched until you pop it.
+      - pop(n) removes the n oldest frames and gives their slots back to the interruption.
+      - acquireFrames(&span) gives the oldest frames that are contiguous in memory as an array, without any copy, and
+        releaseFrames(&span) gives their slots back. The interruption doesn't write the frames of a span until they are
+        released, so they are never torn.
+      - getData() is kept for convenience: it copies the oldest frame, pops it and returns the copy.
+    If the ring buffer is full when ADS has new data, the new frame is dropped and getOverrunCount() is incremented. See 
+    Limitations section to know about the other few limitations that has the library.
+
+    Every frame is tagged with the index of its DRDY edge and the time of the edge (peekInfo() and getDataInfo()), so lost
+    frames are gaps in the sample index. getFrameCounters() tells why they were lost (ring buffer full or DRDY edge while
+    a SPI transaction was open). If ADS_ISR_INSTRUMENTATION is 1 (see ads129xDriverConfig.h), getIsrStats() tells whether
+    the interruption is too slow or your code keeps SPI open too long.
+
+    Lead-off and GPIO status come in the status word of each frame. The interruption compares it with the previous one and
+    stores an event only when it changes (availableStatusEvents() and popStatusEvent()), so your code doesn't need to
+    check every frame. See ADS_STATUS_EVENT_BUFFER_SIZE in ads129xDriverConfig.h.
 
     
     To know which is the minimum SPI speed you need, see page 59, section 9.5.1.2 Serial Clock (SCLK), in the datasheet:
@@ -61,31 +112,36 @@
         T_sampling: signal sample frequency 
         T_clk: ADS clock (typically 2.048 MHz)
         Nbits: number the bits per channels sent by ADS (is the same that ADS_BITS_PER_CHANNEL constant)
-        Nchannels: number of channels that has the ADS chip
+        Nchannels: number of channels that has the ADS chip (multiplied by ADS_DAISY_CHAIN_DEVICES in daisy-chain, plus 24 bits per device)
 
     Be careful that this formula suppose that their is no delay in the SPI master to operate SPI. It isn't the case for Arduino boards
+    The driver computes it for the current CONFIG1 data rate (getMinimumFrameSpiSpeed()) and warns you when RDATAC mode is started
+    with a lower ADS_SPI_FRAME_READ_SPEED (only if ADS_LIBRARY_VERBOSE_LEVEL > 0).
      
     For the development of this library, the revision K (August 2015) of the datasheet was used.
     
     Limitations:
-      1- It hasn't a buffer to save the need data sent by ADS. New data will always overwrite the old data.
+      1- The ring buffer has a fixed size (ADS_FRAME_BUFFER_SIZE). If your code doesn't read the frames fast enough, new frames
+         are dropped (see getOverrunCount()).
       2- Doesn't support send multibyte commands using burst method (see page 63, section 9.5.2.9 Sending Multibyte Commands,
          in the datasheet). See note below.
-      3- Doesn't support multiread and multiwrite registers but their implementation is quite trivial. I you would want to
-         support them, you need to modify readRegister() and writeRegister() methods.
-      4- The maximum SPI speed is 4 MHz instead the theoretical 15/20 MHz due to the lack of the support for multibyte commands using 
-         burst method. See note below. This speed might not be enough for ADS1298 or ADS1298R with high sampling rates. You can use 
+      3- The maximum SPI speed for commands and registers is 4 MHz instead the theoretical 15/20 MHz due to the lack of the support for
+         multibyte commands using burst method. See note below. Frames read in RDATAC mode use their own SPI clock 
+         (ADS_SPI_FRAME_READ_SPEED in ads129xDriverConfig.h) because no commands are sent in this mode. You can use 
          the formula gave above to compute the minimum SPI speed you need.
-      5- Doesn't support multiple device configuration due to (I believe that there are this only two limitations):
-           1- Method that reads the data converted from ADS doesn't support when 2 o more ADS are in Daisy-Chain configuration.
-           2- The workaround for interruptions limit to one the active ADS that can be controlled. So, Cascade configuration is not supported.
+      4- Multiple device configuration is supported with these limitations:
+           1- Daisy-Chain configuration is supported (ADS_DAISY_CHAIN_DEVICES in ads129xDriverConfig.h). The frames of all devices
+              are read in one SPI transfer each DRDY and commands/registers are sent to all devices at the same time. Registers
+              read back are the ones of the first device.
+           2- Cascade configuration is supported up to ADS_MAX_SENSORS (see ads129xDriverConfig.h) sensor objects (max 4), of any model. Each
+              one needs its own CS and DRDY pins and all of them share the SPI bus. Every object has its own ring buffer.
 
            See pages 56 and 57, section 9.4.2 Multiple-Device Configuration, in datsheet for more infromation about Mutiple-device Configuration
 
       Note: implementing burst method and therefore increasing the maximum SPI speed has little sense when Arduino libraries are used. Burst method requiere a high
-            time resolution (optimally 0.1 microseconds) that standard Arduino library doesn't provide. However, SPI max speed for data reading in continuous mode could be increased
-            if different SPISettings are used to send commands and to read the data sent in the continuous mode (in this mode, no commands are sent to retrieve data from ADS chip).
-            However, firstly Arduino boards need to support high SPI transfers. For example, the chip in Arduino zero boards (they use a SAMD21 chip (an ARM M0 microprocessor) allows
+            time resolution (optimally 0.1 microseconds) that standard Arduino library doesn't provide. Instead, SPI max speed for data reading in continuous mode is increased
+            using different SPI settings to send commands and to read the data sent in the continuous mode (in this mode, no commands are sent to retrieve data from ADS chip).
+            However, Arduino boards need to support high SPI transfers. For example, the chip in Arduino zero boards (they use a SAMD21 chip (an ARM M0 microprocessor) allows
             to 24 MHz but it is not recommend to use more than 12 MHz if the peripheral is connected with wires.
 
             To sum up, increase theoretical maximum SPI speed doesn't seem apport much.
@@ -99,26 +155,31 @@
 #ifndef _ADS129X_DRIVER_H_
 #define _ADS129X_DRIVER_H_
 
-#include <Arduino.h>
-
 /* ======= ADS constants section ============= */
 // Import user configuration where ADS_BITS_PER_CHANNEL, ADS_N_CHANNELS, ADS_HAS_RESPIRATION_MODULE and ADS_LIBRARY_VERBOSE_LEVEL are defined
 #include "ads129xDriverConfig.h"
 
+// Hardware abstraction layer. SPI, pins, interrupts and time functions used by the driver (see ads129xHal.h)
+#include "ads129xHal.h"
+
 // Check that all constants are defined by user
 #if !defined (ADS_BITS_PER_CHANNEL) || !defined (ADS_N_CHANNELS) || !defined (ADS_HAS_RESPIRATION_MODULE) || !defined (ADS_LIBRARY_VERBOSE_LEVEL)
 Some constants that are defined in file "ads129xDriverConfig.h" are not defined!!!! To user: Do you delete some constants ?
 #endif
 
+#if ADS_RUNTIME_FRAME_WIDTH && ADS_BITS_PER_CHANNEL != 24
+#error "ADS_RUNTIME_FRAME_WIDTH needs ADS_BITS_PER_CHANNEL = 24 (the ring buffer slots must fit the longest frames)"
+#endif
+
 // To avoid pollute this header with an endless constants related to registers and commands for ADS129x chips, these are declared in ads129xxConstants.h
 #include "ads129xDatasheetConstants.h"
 
 // Time constants. See section 7.6, Timing Requirements: Serial Interface in the datasheet
 // In the datasheet, they use nominal _ADS_T_CLK -> _ADS_T_CLK = 1/2.048MHz
 #define _ADS_T_CLK 0.514 // See page 17, section 9 7.6 Timing Requirements: Serial Interface, in the datasheet. Note: if internal clock is used, max _ADS_T_CLK is 500 ns and then _ADS_T_CLK_2 could be 1, _ADS_T_CLK_4 could be 2 and _ADS_T_CLK_18 could be 9
-#define _ADS_T_CLK_2 ceil(2 * _ADS_T_CLK) // 2 *T _CLK = 1.028 ms. delayMicroseconds function only accept integers. In order to be make sure that the code will always for any chip configuration -> ceil float to the next integer  
-#define _ADS_T_CLK_4 ceil(4 * _ADS_T_CLK) // 4 *T _CLK = 2.056 ms. delayMicroseconds function only accept integers. In order to be make sure that the code will always for any chip configuration -> ceil float to the next integer  
-#define _ADS_T_CLK_18 ceil(18 * _ADS_T_CLK) // 18 * _ADS_T_CLK = 9.252 ms. delayMicroseconds function only accept integers. In order to be make sure that the code will always for any chip configuration -> ceil float to the next integer  
+#define _ADS_T_CLK_2 ceil(2 * _ADS_T_CLK) // 2 *T _CLK = 1.028 us. delayMicroseconds function only accept integers. In order to be make sure that the code will always for any chip configuration -> ceil float to the next integer  
+#define _ADS_T_CLK_4 ceil(4 * _ADS_T_CLK) // 4 *T _CLK = 2.056 us. delayMicroseconds function only accept integers. In order to be make sure that the code will always for any chip configuration -> ceil float to the next integer  
+#define _ADS_T_CLK_18 ceil(18 * _ADS_T_CLK) // 18 * _ADS_T_CLK = 9.252 us. delayMicroseconds function only accept integers. In order to be make sure that the code will always for any chip configuration -> ceil float to the next integer  
 
 // Timing requeriments for SPI interface. These are ignored because there are SPI transactions inside interruptions -> 
 // delay doesn't work and arduino are slow enough that is not necessary to wait any time.
@@ -141,72 +202,299 @@ Some constants that are defined in file "ads129xDriverConfig.h" are not defined!
 #define _ADS_SPI_BIT_ORDER MSBFIRST // See page 64, section 9.5.2.10 RREG: Read From Register, in the datasheet)
 #define _ADS_SPI_MODE SPI_MODE1 // See page 17 in the datasheet
 
+#define _ADS_SPI_FRAME_MAX_SPEED 20000000 // 20 MHz (DVDD >= 2.7 V). See page 17, section 7.7 Switching Characteristics: Serial Interface, in the datasheet
+#if !defined(ADS_SPI_FRAME_READ_SPEED) || ADS_SPI_FRAME_READ_SPEED > _ADS_SPI_FRAME_MAX_SPEED
+#error "ADS_SPI_FRAME_READ_SPEED must be defined and not bigger than 20 MHz"
+#endif
+
+// Plan of the WREG commands that write the registers changed in the register shadow (see flushRegisters()). It uses
+// _ADS_SPI_MAX_SPEED, so it comes after the SPI constants
+#include "ads129xWritePlan.h"
+
 // If VCAP1 is not an issue, t_por allows us to wait only 150 ms BUT I didn't calculate VCAP1 time. See page 96 in the datasheet
 // To make sure that VCAP1 won't be an issue, we wait 1 second. If you use the recomended capacitor for VCAP1 pin (22 micro Faradays), I think 150 ms is enough
-#define _ADS_POWER_UP_DELAY_MS 1000 // Wait time after device is powered up until commands are sent
+#define _ADS_POWER_UP_DELAY_MS 1000 // Default wait time after device is powered up until commands are sent (see setPowerUpDelay())
+#define _ADS_PWDN_WAKE_UP_US 150 // Internal reference wake-up after PWDN goes high. See page 15, section Electrical Characteristics, in the datasheet
+
+// Steps of the power-up and reset sequence (see beginAsync() and poll()). Each one waits until powerUpDeadlineUs
+#define _ADS_POWER_UP_IDLE 0 // No sequence in progress
+#define _ADS_POWER_UP_WAITING_SUPPLY 1 // t_POR and VCAP1 charge
+#define _ADS_POWER_UP_WAITING_PINS 2 // Oscillator and internal reference wake-up after CLKSEL/PWDN are set
+#define _ADS_POWER_UP_WAITING_RESET_PULSE 3 // RESET pin low (t_RST)
+#define _ADS_POWER_UP_WAITING_RESET 4 // 18 t_CLK after a reset, no command can be sent
 
 #define _ADS_READING_DATA_IN_RDATA_MODE 1
 #define _ADS_READING_DATA_IN_RDATAC_MODE 2
 #define _ADS_NO_READING_NEW_DATA 3
 
 #define ADS_PIN_NOT_USED 255 // Max posible value that can take a uint8_t type
+#define _ADS_NO_REGISTRY_SLOT 255
+
+// Check that the ring buffer size is a power of two (slots are addressed with a mask instead of a modulo)
+#if ADS_FRAME_BUFFER_SIZE < 1 || (ADS_FRAME_BUFFER_SIZE & (ADS_FRAME_BUFFER_SIZE - 1)) != 0
+#error "ADS_FRAME_BUFFER_SIZE must be a power of two"
+#endif
+#define _ADS_FRAME_BUFFER_MASK (ADS_FRAME_BUFFER_SIZE - 1)
+
+#if ADS_STATUS_EVENT_BUFFER_SIZE > 128 || (ADS_STATUS_EVENT_BUFFER_SIZE & (ADS_STATUS_EVENT_BUFFER_SIZE - 1)) != 0
+#error "ADS_STATUS_EVENT_BUFFER_SIZE must be 0 or a power of two not bigger than 128"
+#endif
+#define _ADS_STATUS_EVENT_BUFFER_MASK (ADS_STATUS_EVENT_BUFFER_SIZE - 1)
+
+// Free running counters of the ring buffer. They must be read in one instruction by the consumer, so 8 bits counters
+// are used when it is possible (AVR boards can't read 16 bits variables atomically).
+#if ADS_FRAME_BUFFER_SIZE <= 128
+typedef uint8_t _ads_frame_index_t;
+#elif ADS_FRAME_BUFFER_SIZE <= 32768
+typedef uint16_t _ads_frame_index_t;
+#else
+#error "ADS_FRAME_BUFFER_SIZE is too big"
+#endif
+
 /* ======= ads_data_t definition  ============= */
 
+// Compile-time description of the chip models and their frames (ads::chip_traits and ads::frame_traits)
+#include "ads129xFrame.h"
+
+#if ADS_DAISY_CHAIN_DEVICES < 1 || ADS_DAISY_CHAIN_DEVICES > 8
+#error "ADS_DAISY_CHAIN_DEVICES must be between 1 and 8"
+#endif
+
+// Frame of the chip model and bits per channel set in ads129xDriverConfig.h. The types below are aliases of its types.
+typedef ads::frame_traits<ADS_CHIP_USED, ADS_BITS_PER_CHANNEL, ADS_DAISY_CHAIN_DEVICES> ads_frame_traits_t;
+
 // The size of the data sent by ads129xx depends by the number of bits per channel and the number of channels in the chip.
-#if ADS_BITS_PER_CHANNEL == 16
-#define _ADS_DATA_PACKAGE_SIZE (3 + 2 * ADS_N_CHANNELS)
-typedef struct ads_bits_sample_t {
-  uint8_t hi, low;
-} ads_bits_sample_t;
-
-#elif ADS_BITS_PER_CHANNEL == 24
-
-#define _ADS_DATA_PACKAGE_SIZE (3 + 3 * ADS_N_CHANNELS)
-typedef struct ads_bits_sample_t {
-  uint8_t hi, mid, low;
-} ads_bits_sample_t;
+#define _ADS_DEVICE_PACKAGE_SIZE (3 + ADS_BITS_PER_CHANNEL / 8 * ADS_N_CHANNELS)
+static_assert(ads_frame_traits_t::DEVICE_PACKAGE_SIZE == _ADS_DEVICE_PACKAGE_SIZE, "ADS_N_CHANNELS doesn't match ADS_CHIP_USED");
+static_assert(ads::chip_traits<ADS_CHIP_USED>::HAS_RESPIRATION_MODULE == ADS_HAS_RESPIRATION_MODULE, "ADS_HAS_RESPIRATION_MODULE doesn't match ADS_CHIP_USED");
+
+// One channel sample. If ADS_BITS_PER_CHANNEL is 16, it has the fields hi and low. Otherwise, hi, mid and low
+typedef ads_frame_traits_t::sample_t ads_bits_sample_t;
+
+// Data sent by one ADS chip (_ADS_DEVICE_PACKAGE_SIZE bytes)
+typedef ads_frame_traits_t::device_data_t ads_device_data_t;
+
+// In daisy-chain configuration, the frame has the data of all devices one after another (first device first).
+// See page 57, figure 9-24 Daisy-Chain Configuration Timing, in the datasheet
+#define _ADS_DATA_PACKAGE_SIZE (ADS_DAISY_CHAIN_DEVICES * _ADS_DEVICE_PACKAGE_SIZE)
+#define ADS_TOTAL_CHANNELS (ADS_DAISY_CHAIN_DEVICES * ADS_N_CHANNELS)
+// Bytes of a frame (all the devices) with bits per channel. _ADS_DATA_PACKAGE_SIZE is _ADS_FRAME_SIZE(ADS_BITS_PER_CHANNEL)
+#define _ADS_FRAME_SIZE(bits) (ADS_DAISY_CHAIN_DEVICES * (3 + (bits) / 8 * ADS_N_CHANNELS))
+
+// Generic union for data receviced from any ADS129xx chip:
+//    rawData[_ADS_DATA_PACKAGE_SIZE]. Max size (ADS1298 in 24 bit per channel): 24 status bits + 24 bits per channel × 8 channels = 216 bits -> 27 bytes per device.
+//    formatedData: data of the first device (the only one if there isn't daisy-chain)
+//    device[ADS_DAISY_CHAIN_DEVICES]: device[0] is the same than formatedData
+typedef ads_frame_traits_t::data_t ads_data_t;
+static_assert(sizeof(ads_data_t) == _ADS_DATA_PACKAGE_SIZE, "ads_data_t must have the same size than the data sent by ADS");
+
+#if ADS_RUNTIME_FRAME_WIDTH
+// 16 bits frames (DR = 000 in CONFIG1) stored in the ads_data_t slots of the ring buffer. Frames tagged with
+// bitsPerChannel = 16 (see ads_frame_info_t) must be read with this type instead of ads_data_t fields
+typedef ads::slot_frame_traits<ADS_CHIP_USED, 16, ADS_DAISY_CHAIN_DEVICES, sizeof(ads_data_t)> ads_frame16_traits_t;
+typedef ads_frame16_traits_t::data_t ads_data16_t;
+static_assert(sizeof(ads_data16_t) == sizeof(ads_data_t), "16 bits frames must use the ads_data_t slots");
+#endif
+
+// Information of a frame taken in the DRDY interruption
+typedef struct {
+  uint32_t sampleIndex; // Index of the DRDY edge of the frame (0 is the first edge after begin()). Lost frames also have index
+  uint32_t timestampUs; // hal::micros() when DRDY fell (see ADS129xSensor::peekInfo())
+#if ADS_RUNTIME_FRAME_WIDTH
+  uint8_t bitsPerChannel; // 16 or 24: CONFIG1 data rate when the frame was read (see ADS129xSensor::getBitsPerChannel())
+#endif
+} ads_frame_info_t;
+
+// Monotonic counters of the DRDY interruption since begin(). In RDATAC mode, every DRDY edge is stored or lost:
+// drdyEdges = framesStored + framesDropped + edgesWhileSpiOpen + edges while no frame was requested (SDATAC mode, ...)
+typedef struct {
+  uint32_t drdyEdges; // DRDY edges seen, including the edges merged while the interruption was masked
+  uint32_t framesStored; // Frames written in the ring buffer
+  uint32_t framesDropped; // Frames lost because the ring buffer was full (the same than getOverrunCount())
+  uint32_t edgesWhileSpiOpen; // Frames lost because their DRDY edge arrived while a SPI transaction was open
+} ads_frame_counters_t;
+
+#if ADS_ISR_INSTRUMENTATION
+// Histogram of times in microseconds with logarithmic buckets: buckets[0] counts 0 us, buckets[k] counts
+// [2^(k - 1), 2^k) us and the last bucket counts everything from 2^(ADS_HISTOGRAM_BUCKETS - 2) us (16 ms)
+#define ADS_HISTOGRAM_BUCKETS 16
+typedef struct {
+  uint32_t buckets[ADS_HISTOGRAM_BUCKETS];
+  uint32_t maxUs; // Longest time
+} ads_histogram_t;
+
+// Measures of the DRDY interruption and the SPI transactions since begin() or resetIsrStats() (see ADS129xSensor::getIsrStats())
+typedef struct {
+  ads_histogram_t drdyToCsLow; // From the DRDY edge to CS low in the interruption. Long times: it was masked by a SPI transaction
+  ads_histogram_t isrCsLow; // CS low in the interruption (frame read, including RDATA command). With ADS_ASYNC_FRAME_READ,
+                            // until the transfer finishes
+  ads_histogram_t isr; // Whole DRDY interruption (with ADS_ASYNC_FRAME_READ, without the completion callback)
+  ads_histogram_t spiHold; // CS low by your code: commands, registers and transactions left open with keepSpiOpen = true
+  uint32_t isrSpiTransactions, isrSpiBytes; // SPI transactions opened and bytes moved by the interruption
+  uint32_t spiTransactions, spiBytes; // The same for your code
+} ads_isr_stats_t;
 #endif
 
-// Generic union for data receviced from any ADS129xx chip
-typedef union {
-  byte rawData[_ADS_DATA_PACKAGE_SIZE]; // Max size (ADS1298 in 24 bit per channel): 24 status bits + 24 bits per channel × 4 channels = 216 -> 27 bytes.
-  struct {
-    byte statusWord[3];
-    ads_bits_sample_t channel[ADS_N_CHANNELS];
-  } formatedData;
-} ads_data_t;
+// Change of the status word of a device (see ADS129xSensor::popStatusEvent())
+typedef struct {
+  uint32_t sampleIndex; // Sample index of the first frame with the new status (see ads_frame_info_t)
+  uint8_t device; // Device in daisy-chain (0 if there isn't daisy-chain)
+  ads::status_t status; // New status
+  ads::status_t changed; // Bits that changed (1 -> changed). All 1 in the first event of each device
+} ads_status_event_t;
 
 /* ======= ADS129xSensor class definition  ============= */
-class ADS129xSensor {
+// Driver of an ADS chip of the model chip (ADS_1294, ADS_1294R, ... see ads129xDriverConfig.h) that sends bits (16 or 24)
+// per channel. ADS129xSensor (defined below the class) is the one of ADS_CHIP_USED and ADS_BITS_PER_CHANNEL.
+template <uint8_t chip, uint8_t bits = ADS_BITS_PER_CHANNEL>
+class ADS129xChipSensor {
+  public:
+    // Frames of the chip model and bits per channel of the class (see ads129xFrame.h)
+    typedef ads::frame_traits<chip, bits, ADS_DAISY_CHAIN_DEVICES> frame_traits_t;
+    typedef typename frame_traits_t::sample_t sample_t;
+    typedef typename frame_traits_t::device_data_t device_data_t;
+    typedef typename frame_traits_t::data_t data_t;
+    static constexpr uint8_t N_CHANNELS = frame_traits_t::N_CHANNELS;
+    static constexpr uint8_t TOTAL_CHANNELS = frame_traits_t::TOTAL_CHANNELS;
+    static constexpr uint16_t PACKAGE_SIZE = frame_traits_t::PACKAGE_SIZE;
+
+    // Read-only view of frames that are in the ring buffer (see acquireFrames())
+    typedef struct {
+      const data_t *frames;
+      const ads_frame_info_t *info; // info[i] is the information of frames[i]
+      uint16_t nFrames;
+    } frame_span_t;
+
+    // Frame of a daisy-chain with the channels of all devices together: channel[d * N_CHANNELS + i] is the
+    // channel i of the device d. Use demultiplexFrame() to get it from a data_t.
+    typedef struct {
+      byte statusWord[ADS_DAISY_CHAIN_DEVICES][3];
+      sample_t channel[TOTAL_CHANNELS];
+    } daisy_frame_t;
+
+    static_assert(sizeof(data_t) == PACKAGE_SIZE, "data_t must have the same size than the data sent by ADS");
+    static_assert(!ADS_RUNTIME_FRAME_WIDTH || bits == 24, "ADS_RUNTIME_FRAME_WIDTH needs 24 bits per channel (the ring buffer slots must fit the longest frames)");
+
   private:
-    volatile boolean isSpiOpen, hasNewData;
+    volatile boolean isSpiOpen;
+#if ADS_ASYNC_FRAME_READ
+    // The DRDY interruption found the SPI bus busy with an asynchronous frame read (of any sensor, see ads129xDriver.cpp).
+    // The interruption that finishes the read calls it again (see _privateRunDeferredDrdy_()), so no interruption waits
+    // for another one
+    volatile boolean isDrdyDeferred;
+    uint32_t deferredDrdyUs; // Time when the deferred interruption was called
+#endif
     volatile uint8_t readingStatus;
+    uint8_t registrySlot; // Slot of the ISR registry taken in begin(). _ADS_NO_REGISTRY_SLOT if begin() wasn't called
+    // Shadow of the register map: last value written in/read from each register (see Register shadow methods)
+    byte registerShadow[ads::registers::N_REGISTERS];
+    uint32_t dirtyRegisters; // Bit i is 1 -> register i was changed in the shadow but it wasn't written in ADS yet
+    boolean holdingRegisterChanges; // Between beginRegisterChanges() and endRegisterChanges()
     uint8_t chipSelectPin, drdyPin, resetPin, startPin, pwdnPin, clkselPin;
 
-    // It is declarated in order to allocate memory and avoid to allocate every time that new data is available
-    // In the worst case scenario, it takes 27 bytes ( in ADS1298 or ADS1298R model with 24 bits resolution).
-    ads_data_t adsData; // Use constant _ADS_DATA_PACKAGE_SIZE to know how many bytes has the data sent by ADS chip
+    // Power-up and reset sequence (see beginAsync() and poll())
+    uint8_t powerUpState; // _ADS_POWER_UP_*
+    uint32_t powerUpDeadlineUs; // hal::micros() when the wait of the current step finishes
+    uint16_t powerUpDelayMs; // See setPowerUpDelay()
+
+    // Single-producer (DRDY interruption) / single-consumer (your code) ring buffer. The interruption SPI-transfers
+    // the frame directly into the slot, so no copy is done inside the interruption.
+    // frameHead is only written by the interruption and frameTail is only written by the consumer.
+    data_t frameBuffer[ADS_FRAME_BUFFER_SIZE];
+    volatile _ads_frame_index_t frameHead, frameTail;
+    volatile uint32_t overrunCount; // Frames dropped because the ring buffer was full. It never decreases
+    ads_frame_info_t frameInfo[ADS_FRAME_BUFFER_SIZE]; // frameInfo[i] is the information of frameBuffer[i]
+
+#if ADS_STATUS_EVENT_BUFFER_SIZE > 0
+    // Status word changes. Another single-producer/single-consumer ring buffer like the frames one
+    ads_status_event_t statusEvents[ADS_STATUS_EVENT_BUFFER_SIZE];
+    volatile uint8_t statusEventHead, statusEventTail;
+    byte lastStatusWord[ADS_DAISY_CHAIN_DEVICES][3]; // Status word of the last event of each device
+    boolean hasLastStatusWord[ADS_DAISY_CHAIN_DEVICES];
+#endif
+    volatile uint32_t drdyEdgeCount, framesStoredCount, edgesWhileSpiOpenCount; // See ads_frame_counters_t
+
+    // DRDY edge tracking. The interruption is masked while a SPI transaction is open (so a command doesn't mix with a
+    // frame read) and the DRDY edges of that time are merged in one call. DRDY is periodic, so the merged edges are
+    // counted from the time since the last edge.
+    volatile boolean isLastDrdyValid; // False after conversions (re)start: the time since the last edge isn't a DRDY period
+    uint32_t lastDrdyUs; // Time of the last DRDY edge
+    uint32_t drdyPeriodQus; // 1 / data rate, in quarters of microsecond
+#if ADS_RUNTIME_FRAME_WIDTH
+    // Bits per channel and bytes of the frames that ADS sends with the CONFIG1 value of the shadow (see getBitsPerChannel())
+    volatile uint8_t frameBits, frameSize;
+#endif
+
+    // Copy of the last frame returned by getData()
+    data_t adsData; // Use constant PACKAGE_SIZE to know how many bytes has the data sent by ADS chip
+    ads_frame_info_t adsDataInfo;
+
+#if ADS_ISR_INSTRUMENTATION
+    // Written by the interruption and by the SPI transactions of your code. Every field is written only by one of them
+    // (isrSpi* and the interruption histograms or spi* and spiHold), so no update is lost
+    ads_isr_stats_t isrStats;
+    uint32_t spiOpenUs; // Time when CS went low
+    volatile boolean isIsrTransaction; // The open SPI transaction belongs to the interruption
+#endif
 
     /* ==== Methods ===== */
-    void beginSpiTransaction();
+    // clockHz is only used if the transaction isn't already open
+    void beginSpiTransaction(uint32_t clockHz = _ADS_SPI_MAX_SPEED);
     void endSpiTransaction();
 
     // Low level function. It only send command without any knowloadge of timing restrictions for
     // specific command.
     void sendCommand(byte command, boolean keepSpiOpen = false);
-    void resetADS();
+    // Start the reset of the power-up sequence (RESET pin or RESET command). poll() finishes it
+    void startReset();
+    // Wait usDelay microseconds from now in the current step of the power-up sequence
+    void setPowerUpWait(uint32_t usDelay) {
+      powerUpDeadlineUs = ads::hal::micros() + usDelay + 1; // The current microsecond has already started
+    }
+    // Values of the registers after a reset. No register is dirty
+    void setRegisterShadowToResetValues();
+    // Write the changes done by a helper method, unless they are being held (see beginRegisterChanges())
+    void writeRegisterChanges(boolean keepSpiOpen);
+    // Called when ADS (re)starts the conversions or the data rate changes (and with it, the frame length if
+    // ADS_RUNTIME_FRAME_WIDTH is 1)
+    void restartDrdyTracking();
+    // Store an event for each device whose status word changed in the frame. Called inside the interruption
+    void trackStatusWords(const data_t *frame, uint32_t sampleIndex);
+    // Body of _privateReadDataFromChip_(). entryUs is the time when the interruption started
+    void readDataFromChip(uint32_t entryUs);
+    // Bytes of a frame (all the devices) with bitsPerChannel. PACKAGE_SIZE is frameSizeFor(bits)
+    static uint8_t frameSizeFor(uint8_t bitsPerChannel) {
+      return ADS_DAISY_CHAIN_DEVICES * (3 + bitsPerChannel / 8 * N_CHANNELS);
+    }
+    // Count the bytes moved in the open SPI transaction (see getIsrStats())
+    void countSpiBytes(uint8_t nBytes) {
+#if ADS_ISR_INSTRUMENTATION
+      if (isIsrTransaction)
+        isrStats.isrSpiBytes += nBytes;
+      else
+        isrStats.spiBytes += nBytes;
+#else
+      (void) nBytes;
+#endif
+    }
     
   public:
     // For limitations in attachInterrupt and the workaround, this function must be public but YOU MUST NOT USE IT
     // Read the new data from ADS when ADS indicate that new data is available. This method is called inside an interruption
     void _privateReadDataFromChip_();
+    // Called when the asynchronous transfer started by _privateReadDataFromChip_() finishes. YOU MUST NOT USE IT
+    void _privateFrameReadCompleted_();
+#if ADS_ASYNC_FRAME_READ
+    // Call the DRDY interruption deferred by _privateReadDataFromChip_(), if any. YOU MUST NOT USE IT
+    void _privateRunDeferredDrdy_();
+#endif
 
   public:
     // If you don't want to use an optional pin, you can pass the constant ADS_PIN_NOT_USED
     // See Limitations section in the top of this file to know the limitations that has this library
     // Before using any othr method, you MUST call begin() function
-    ADS129xSensor(uint8_t chipSelectPin, uint8_t drdyPin, uint8_t resetPin = ADS_PIN_NOT_USED, uint8_t startPin = ADS_PIN_NOT_USED,
-                  uint8_t pwdnPin = ADS_PIN_NOT_USED, uint8_t clkselPin = ADS_PIN_NOT_USED) {
+    ADS129xChipSensor(uint8_t chipSelectPin, uint8_t drdyPin, uint8_t resetPin = ADS_PIN_NOT_USED, uint8_t startPin = ADS_PIN_NOT_USED,
+                      uint8_t pwdnPin = ADS_PIN_NOT_USED, uint8_t clkselPin = ADS_PIN_NOT_USED) {
       this->chipSelectPin = chipSelectPin;
       this->drdyPin = drdyPin;
       this->resetPin = resetPin;
@@ -214,10 +502,43 @@ class ADS129xSensor {
       this->pwdnPin = pwdnPin;
       this->clkselPin = clkselPin;
       isSpiOpen = false;
-      hasNewData = false;
+      registrySlot = _ADS_NO_REGISTRY_SLOT;
+#if ADS_ASYNC_FRAME_READ
+      isDrdyDeferred = false;
+      deferredDrdyUs = 0;
+#endif
+      frameHead = 0;
+      frameTail = 0;
+      overrunCount = 0;
+      drdyEdgeCount = 0;
+      framesStoredCount = 0;
+      edgesWhileSpiOpenCount = 0;
+      isLastDrdyValid = false;
+      lastDrdyUs = 0;
+#if ADS_STATUS_EVENT_BUFFER_SIZE > 0
+      statusEventHead = 0;
+      statusEventTail = 0;
+      for (uint8_t d = 0; d < ADS_DAISY_CHAIN_DEVICES; d++)
+        hasLastStatusWord[d] = false;
+#endif
+      drdyPeriodQus = 0;
       readingStatus = _ADS_NO_READING_NEW_DATA;
+      holdingRegisterChanges = false;
+      powerUpState = _ADS_POWER_UP_IDLE;
+      powerUpDeadlineUs = 0;
+      powerUpDelayMs = _ADS_POWER_UP_DELAY_MS;
+#if ADS_ISR_INSTRUMENTATION
+      isIsrTransaction = false;
+      spiOpenUs = 0;
+      isrStats = ads_isr_stats_t(); // All zeros
+#endif
+      setRegisterShadowToResetValues();
+#if ADS_RUNTIME_FRAME_WIDTH
+      frameBits = ads::registers::config1::bitsPerChannel(ads::registers::config1::RESET_VALUE);
+      frameSize = frameSizeFor(frameBits);
+#endif
     };
-    ~ADS129xSensor() {};
+    ~ADS129xChipSensor() {};
 
     // Configure pins and interrupts, performs the chip power-up, leave
     // it in in default reset options and ready to accept commands or read/write register
@@ -229,21 +550,122 @@ class ADS129xSensor {
     //
     // See page 65 in the datasheet for more information about which are the registers reset values
     void begin();
-    // Call to finish all data conversion and release ADS. Then you can control another ADS chip calling the begin() method.
-    // GPIO pins are also released. Call begin method to use ADS again
+    // Non-blocking version of begin(): the waits of the power-up sequence (the power-up delay, the wake-up of the internal
+    // reference, the reset pulse, ...) are deadlines instead of delays. beginAsync() does the first steps and returns at
+    // once. Then, call poll() (for example, in loop() or while other peripherals boot) until it returns true. Until then,
+    // don't call any other method.
+    //
+    // Example:
+    //    sensor.setPowerUpDelay(150); // 22 uF in VCAP1
+    //    sensor.beginAsync();
+    //    while (!sensor.poll())
+    //      bootOtherPeripheral();
+    void beginAsync();
+    // Do the next steps of the power-up or reset sequence whose waits have finished. Return true when no sequence is in
+    // progress (the sequence has finished). It never waits more than a few microseconds.
+    boolean poll();
+    // Microseconds until poll() has something to do (0 if no sequence is in progress or the wait has finished)
+    uint32_t getPowerUpTimeLeftUs();
+    // Non-blocking reset (for example, to recover ADS in the field): RESET pin if it was given to the constructor or RESET
+    // command otherwise. Call poll() until it returns true. As after begin(), ADS is left with the reset values of the
+    // registers, in SDATAC mode and with the conversions stopped (the ID register is checked again).
+    void resetAsync();
+    // Wait after begin()/beginAsync() before the first command is sent: t_POR (2^18 t_CLK, 128 ms) plus the time until
+    // VCAP1 > 1.1 V, that depends on the VCAP1 capacitor. _ADS_POWER_UP_DELAY_MS (1 second) by default. 150 ms is enough
+    // with the recommended 22 uF capacitor. If the supply was powered up earlier (for example, the microcontroller restarted
+    // but ADS didn't), it can be 0. See page 96, section 11 Power Supply Recommendations, in the datasheet
+    void setPowerUpDelay(uint16_t ms) {
+      powerUpDelayMs = ms;
+    }
+
+    // Call to finish all data conversion and release ADS. Its slot is given back, so another sensor can call begin().
+    // GPIO pins are also released. Call begin method to use ADS again. It does nothing if begin() wasn't called
     void end();
 
-    // Return the data sent by ADS and mark the data as no new (hasNewDataAvailable will return false until the next data sent
-    // by ADS is received). Be aware that there is no buffer, so new data override the old.
-    ads_data_t * getData() {
-      hasNewData = false; // Mark adsData as read
-      return &adsData;
-    }
+    // Copy the oldest frame sent by ADS, remove it from the ring buffer and return the copy. The copy is valid until
+    // the next call to getData(). If there isn't any frame available, the last returned frame is returned again.
+    data_t * getData();
 
     // Method to check if new data is available.
     boolean hasNewDataAvailable() volatile {
-      return hasNewData;
+      return available() > 0;
+    }
+
+    /* ====== Ring buffer methods ========== */
+    // Number of frames waiting to be read in the ring buffer
+    uint16_t available() volatile {
+      _ads_frame_index_t nFrames = frameHead - frameTail;
+      _ADS_MEMORY_BARRIER(); // Frames must be read after the counter
+      return nFrames;
+    }
+    // Number of frames waiting to be read that are contiguous in memory from peek(0). It's less than available() when the
+    // frames wrap around the end of the ring buffer. Useful to process the frames as an array (see ads129xDecoder.h)
+    uint16_t availableContiguous();
+    // Return a pointer to the index-th oldest frame (0 is the oldest) without removing it. The frame is not modified
+    // by the interruption until it is removed with pop(). Return NULL if index >= available().
+    data_t * peek(uint16_t index = 0);
+    // Remove the nFrames oldest frames and give their slots back to the interruption. If nFrames > available(), all
+    // the available frames are removed.
+    void pop(uint16_t nFrames = 1);
+    // Number of frames dropped because the ring buffer was full. It is a monotonic counter.
+    uint32_t getOverrunCount();
+    // Fill span with the oldest frames (up to maxFrames) that are contiguous in memory and return how many they are (0 if
+    // there isn't any frame). No frame is copied: span points to the ring buffer and the interruption doesn't write these
+    // slots until releaseFrames() is called. Calling it again before releaseFrames() gives the same frames (and the new
+    // ones that are contiguous). If ADS_RUNTIME_FRAME_WIDTH is 1, all the frames of a span have the same bits per channel
+    // (span->info[0].bitsPerChannel), so the span can be decoded at once (see ads129xDecoder.h).
+    uint16_t acquireFrames(frame_span_t *span, uint16_t maxFrames = 0xFFFF);
+    // Give the frames of the span back to the interruption (span must be the last acquired span)
+    void releaseFrames(const frame_span_t *span) {
+      pop(span->nFrames);
+    }
+    // Information (sample index and timestamp) of the index-th oldest frame. Return NULL if index >= available().
+    // Gaps in sampleIndex are lost frames (see getFrameCounters()). The timestamp is the time of the DRDY edge: when the
+    // interruption was delayed by a SPI transaction, it's estimated from the last edge and the DRDY period.
+    ads_frame_info_t * peekInfo(uint16_t index = 0);
+    // Information of the last frame returned by getData()
+    ads_frame_info_t * getDataInfo() {
+      return &adsDataInfo;
+    }
+    // Copy the counters of the DRDY interruption (see ads_frame_counters_t)
+    void getFrameCounters(ads_frame_counters_t *counters);
+
+#if ADS_ISR_INSTRUMENTATION
+    /* ====== Instrumentation methods (ADS_ISR_INSTRUMENTATION) ========== */
+    // Copy the measures of the interruption and the SPI transactions (see ads_isr_stats_t). They are copied with the
+    // interruptions disabled, so the copy is consistent. Example: frames are lost (edgesWhileSpiOpen in getFrameCounters())
+    //    - spiHold has long times -> your code keeps SPI open too long (keepSpiOpen = true).
+    //    - isr is near the DRDY period (250 us at 4 kSPS) -> the interruption is too slow (raise ADS_SPI_FRAME_READ_SPEED,
+    //      use ADS_ASYNC_FRAME_READ, ...).
+    //    - drdyToCsLow has long times but spiHold doesn't -> another interruption or library delays the DRDY interruption.
+    void getIsrStats(ads_isr_stats_t *stats);
+    // Clear the histograms and counters
+    void resetIsrStats();
+#endif
+
+#if ADS_STATUS_EVENT_BUFFER_SIZE > 0
+    /* ====== Status word methods ========== */
+    // The status word of each frame has the lead-off status (LOFF_STATP and LOFF_STATN) and the GPIO data bits (see
+    // ads::decodeStatusWord() in ads129xFrame.h). LOFF_STATP/N registers can't be read in RDATAC mode, so the interruption
+    // tracks them: an event is stored only when the status word of a device changes (the first frame after begin() gives
+    // the initial status of every device). Frames with an invalid status word (bad read) are ignored.
+
+    // Number of status events waiting to be read
+    uint8_t availableStatusEvents() volatile {
+      uint8_t nEvents = statusEventHead - statusEventTail;
+      _ADS_MEMORY_BARRIER(); // Events must be read after the counter
+      return nEvents;
     }
+    // Copy the oldest status event in event and remove it. Return false if there isn't any event
+    boolean popStatusEvent(ads_status_event_t *event);
+#endif
+
+    /* ====== Daisy-chain methods ========== */
+    // Split a frame read from a daisy-chain (ADS_DAISY_CHAIN_DEVICES devices, see ads129xDriverConfig.h) in the status 
+    // words of every device and the TOTAL_CHANNELS channels of all devices together. Channel i of device d goes to
+    // daisyFrame->channel[d * N_CHANNELS + i]. It can be called with a frame returned by peek() or getData().
+    // If ADS_RUNTIME_FRAME_WIDTH is 1, only 24 bits frames can be split (use the decoders of ads129xDecoder.h for both).
+    static void demultiplexFrame(const data_t *frame, daisy_frame_t *daisyFrame);
 
 
     /* ====== Methods that use hardware pins ========== */
@@ -288,6 +710,45 @@ class ADS129xSensor {
     //    DO instead:
     //      writeRegister(ads::registers::chnSet::REG_ADDR_CH1SET, ads::registers::chnSet::DISABLE_CHANNEL | ads::registers::chnSet::GAIN_6X);
     void writeRegister(byte registAddr, byte value, boolean keepSpiOpen = false);
+
+    // Multi-register versions of readRegister() and writeRegister(). count consecutive registers, starting at startAddr, are
+    // read/written with only one RREG/WREG command (see page 64, sections 9.5.2.10 RREG and 9.5.2.11 WREG, in the datasheet).
+    // buffer must have space for count registers. The same warnings of readRegister() and writeRegister() apply.
+    // If ADS is in RDATAC mode, nothing is sent and readRegisters() fills buffer with 0xFF.
+    void readRegisters(byte startAddr, uint8_t count, byte *buffer, boolean keepSpiOpen = false);
+    void writeRegisters(byte startAddr, uint8_t count, const byte *buffer, boolean keepSpiOpen = false);
+    // Read the whole register map (ads::registers::N_REGISTERS registers, from ID to WCT2) with one RREG command.
+    // buffer[i] is the value of the register with address i. Useful to verify the configuration.
+    void readAllRegisters(byte *buffer, boolean keepSpiOpen = false);
+
+    /* =====  Register shadow methods  ====== */
+    // The driver keeps a copy (shadow) of the register map in RAM. It's set to the reset values when ADS is reset and it's
+    // updated every time a register is read or written, so the helper methods ({enable/disable}Channel, ...) don't read
+    // registers through SPI: they change the shadow and write only the registers that have changed.
+    // ADS changes LOFF_STATP, LOFF_STATN and the GPIO data bits by itself -> their shadow values are the last values read.
+
+    // Value of the register in the shadow. No SPI communication is done, so it can be called in RDATAC mode
+    byte getRegisterShadow(byte registAddr) {
+      return registerShadow[registAddr];
+    }
+    // Change a register only in the shadow. It's written in ADS by flushRegisters() (only if value is different)
+    void setRegisterShadow(byte registAddr, byte value);
+    // Write the registers changed in the shadow and not written yet. They are written with as few SPI bytes as possible
+    // (consecutive registers with one WREG command), CONFIG1 and RESP (they restart the conversions) last and all of them
+    // in the same SPI transaction. See ads129xWritePlan.h
+    void flushRegisters(boolean keepSpiOpen = false);
+    // The WREG commands that flushRegisters() would send now. ads::plan::estimateUs(plan) is the time they would take
+    // (for example, to know how many samples a reconfiguration in the middle of a recording would lose)
+    void getFlushPlan(ads::plan::plan_t *plan) {
+      ads::plan::make(dirtyRegisters, *plan);
+    }
+    // Between these calls, helper methods ({enable/disable}Channel, ...) only change the shadow. endRegisterChanges() writes
+    // all the changes at once with flushRegisters(). Example: configure 8 channels with one short SPI transaction.
+    void beginRegisterChanges();
+    void endRegisterChanges(boolean keepSpiOpen = false);
+
+    // Write the reset values in all writable registers. It is done in one SPI transaction with two WREG commands
+    // (LOFF_STATP and LOFF_STATN are read-only and they are in the middle of the register map)
     void setAllRegisterToResetValuesWithoutResetCommand(boolean keepSpiOpen = false);
 
 
@@ -326,6 +787,8 @@ class ADS129xSensor {
     void sendSPICommandSTOP(boolean keepSpiOpen = false);
 
     // Be aware that when RDATAC command is sent, the any other command except SDATAC will be ignored
+    // In RDATAC mode, frames are read with ADS_SPI_FRAME_READ_SPEED SPI clock. If ADS_LIBRARY_VERBOSE_LEVEL > 0, a message is printed 
+    // when this clock is lower than getMinimumFrameSpiSpeed()
     void sendSPICommandRDATAC(boolean keepSpiOpen = false);
     void sendSPICommandSDATAC(boolean keepSpiOpen = false);    
     // Be careful! This method tells the ADS driver to issue the RDATA SPI command and read the sample 
@@ -334,8 +797,36 @@ class ADS129xSensor {
     void sendSPICommandRDATA(boolean keepSpiOpen = false);
 
 
+    // Data rate (samples per second) configured in CONFIG1 register
+    uint16_t getDataRate() {
+      return ads::registers::config1::dataRate(registerShadow[ads::registers::config1::REG_ADDR]);
+    }
+    // Bits per channel (16 or 24) of the frames that ADS sends with the CONFIG1 value of the register shadow. It's always
+    // bits if ADS_RUNTIME_FRAME_WIDTH is 0 (see ads129xDriverConfig.h)
+    uint8_t getBitsPerChannel() {
+#if ADS_RUNTIME_FRAME_WIDTH
+      return frameBits;
+#else
+      return bits;
+#endif
+    }
+    // Bytes of the frames that ADS sends with the current bits per channel (all the devices of the daisy-chain)
+    uint8_t getFrameSize() {
+#if ADS_RUNTIME_FRAME_WIDTH
+      return frameSize;
+#else
+      return PACKAGE_SIZE;
+#endif
+    }
+    // Minimum SPI clock (in Hz) needed to read a whole frame before the next one is ready with the current data rate.
+    // See the formula at the top of this file
+    uint32_t getMinimumFrameSpiSpeed();
+
     /* ======= Class methods class implementing typical ADS configurations  ============= */
 
+    // These methods use the register shadow (no registers are read) and they write only the registers that change.
+    // See beginRegisterChanges() to write the changes of several calls at once.
+
     // Only disable ECG channel, without changing the other bits (so, without changing the other configuration)
     // Texas Instruments recommends to short the inputs when power down a channel. So setInputAsShorted argument
     // is facilitate.
@@ -357,4 +848,14 @@ class ADS129xSensor {
     void enableChannelAndSetGain(uint8_t nChannel, byte channelGainConstant, int8_t channelInput = -1, boolean keepSpiOpen = false);
 };
 
+// Sensor of the chip model and bits per channel set in ads129xDriverConfig.h
+typedef ADS129xChipSensor<ADS_CHIP_USED, ADS_BITS_PER_CHANNEL> ADS129xSensor;
+
+// Read-only view of frames that are in the ring buffer of an ADS129xSensor (see ADS129xSensor::acquireFrames())
+typedef ADS129xSensor::frame_span_t ads_frame_span_t;
+
+// Frame of a daisy-chain with the channels of all devices together: channel[d * ADS_N_CHANNELS + i] is the
+// channel i of the device d. Use ADS129xSensor::demultiplexFrame() to get it from an ads_data_t.
+typedef ADS129xSensor::daisy_frame_t ads_daisy_frame_t;
+
 #endif /* _ADS129X_DRIVER_H__ */
@@ -1,9 +1,9 @@
 /*
- * In this file, user must edit the constants ADS_CHIP_USED and ADS_BITS_PER_CHANNEL (lines 20 and 30) to set
+ * In this file, user must edit the constants ADS_CHIP_USED and ADS_BITS_PER_CHANNEL (User editable section) to set
  * which ADS chip will be used and how many bits wants per channel.  
  * 
  * In your code, ADS_BITS_PER_CHANNEL, ADS_N_CHANNELS and ADS_HAS_RESPIRATION_MODULE will be available if 
- * you have in mind to change ADS chip. See lines 30 and 42 for the definitions of them
+ * you have in mind to change ADS chip. See User editable and DON'T TOUCH sections for the definitions of them
  */
 #ifndef _ADS129X_DRIVER_CONFIG_H_
 #define _ADS129X_DRIVER_CONFIG_H_
@@ -16,8 +16,17 @@
 #define ADS_1298 5
 #define ADS_1298R 6
 
+// Hardware abstraction layers (HAL) supported. See ads129xHal.h
+#define ADS_HAL_ARDUINO 1 // Arduino SPI library and Arduino pins/interrupts functions
+#define ADS_HAL_HOST_SIMULATOR 2 // Host computer (Linux, ...) with the ADS chip simulator in extras/simulator
+#define ADS_HAL_HOST_MOCK 3 // Host computer with a mocked SPI bus that takes no time (extras/benchmark). Only for benchmarks
+#define ADS_HAL_LINUX 4 // Linux computer or gateway with /dev/spidev and the GPIO character device (extras/linux)
+
 /* ============ User editable ============= */
+// Host builds can set ADS_CHIP_USED and ADS_BITS_PER_CHANNEL from the compiler command line (ex: -DADS_CHIP_USED=ADS_1298)
+#ifndef ADS_CHIP_USED
 #define ADS_CHIP_USED ADS_1294 // Put here the chip used. You have above definitions to help you. For example, here I chose to use ADS1294 chip 
+#endif
 
 // Number of bits per channel that ADS chip will sent over SPI. It doesn't mean that sample was adquiered with this resolution. 
 // The number of bits per channel depends with data rate (sample frequency). See page 53, section 9.4.1.3.2 Readback length in 
@@ -27,7 +36,20 @@
 // Note: Datasheet says in 32 kSPS and 64 kSPS, the bits per channel send by ADS is 16 BUT ADS max sample frequency is 32 kSPS. 
 //       I think that maybe datasheet wanted to say 16 kSPS instead of 64 kSPS. I don't know. I used the datasheet, revision K as reference. 
 //       If datasheet is wrong, in ads129xDatasheetConstants.h is incorrect (look for usage of ADS_BITS_PER_CHANNEL)   
-#define ADS_BITS_PER_CHANNEL 24 // Could be 16 or 24. 
+#ifndef ADS_BITS_PER_CHANNEL
+#define ADS_BITS_PER_CHANNEL 24 // Could be 16 or 24.
+#endif
+
+// 1 -> the bits per channel follow the data rate written in CONFIG1 at runtime: 16 when DR = 000 (32 kSPS in high
+// resolution mode, 16 kSPS in low power mode), 24 otherwise (see ads::registers::config1::bitsPerChannel()). The DRDY
+// interruption reads frames of the current length and tags every frame with its bits per channel (see
+// ads_frame_info_t::bitsPerChannel), so a program can change between 32 kSPS and 1 kSPS without being compiled again.
+// The ring buffer slots keep the size of 24 bits frames, so ADS_BITS_PER_CHANNEL must be 24. 16 bits frames are decoded
+// with ads_frame16_traits_t (see ads129xDecoder.h).
+// 0 -> the bits per channel are always ADS_BITS_PER_CHANNEL
+#ifndef ADS_RUNTIME_FRAME_WIDTH
+#define ADS_RUNTIME_FRAME_WIDTH 0 // 0 or 1
+#endif
 
 // This define specifies how much verbosity you want when you use the library. It can take the following valuesre:
 //    0 -> No messages (recomended if memory program is critical. It avoids to import Serial library and send message through Serial.print() )
@@ -35,6 +57,76 @@
 //    2-> all (for debug purposes only)
 #define ADS_LIBRARY_VERBOSE_LEVEL 1 // 0, 1, 2
 
+// Number of frames (ads_data_t) that the driver can keep until your code reads them. The DRDY interruption stores every 
+// frame sent by ADS in a ring buffer of this size. If the ring buffer is full, the new frame is dropped and counted
+// (see getOverrunCount() method in ads129xDriver.h).
+// It MUST be a power of two. Each frame takes _ADS_DATA_PACKAGE_SIZE bytes (27 bytes per daisy-chained device in the worst case: ADS1298 with 24 bits per channel)
+#ifndef ADS_FRAME_BUFFER_SIZE
+#define ADS_FRAME_BUFFER_SIZE 8 // 1, 2, 4, 8, 16, ...
+#endif
+
+// Number of status word changes (lead-off and GPIO events) that the driver can keep until your code reads them. The DRDY
+// interruption compares the status word of each frame (and each daisy-chained device) with the previous one and stores an
+// event only when LOFF_STATP, LOFF_STATN or GPIO bits change (see ADS129xSensor::popStatusEvent()). If the buffer is
+// full, the change is stored later (when there is room), so the last status is never lost.
+// It MUST be a power of two and not bigger than 128. 0 -> status changes aren't tracked (the interruption is a bit shorter)
+#ifndef ADS_STATUS_EVENT_BUFFER_SIZE
+#define ADS_STATUS_EVENT_BUFFER_SIZE 4 // 0, 1, 2, 4, 8, ..., 128
+#endif
+
+// Number of ADS chips connected in daisy-chain configuration (see page 56, section 9.4.2.2 Daisy-Chain Mode, in the datasheet).
+// All of them must be the same model (the one of the sensor object, ADS_CHIP_USED for ADS129xSensor). They share CS, SCLK, DIN and DRDY (the DRDY of the first device) and
+// DOUT of each device is connected to DAISY_IN of the previous one. The first device is the one whose DOUT is connected to
+// the microcontroller. Each DRDY, the frames of all devices are read with one SPI transfer. DAISY_EN bit of CONFIG1 must be 0 
+// (it's its reset value). Use ADS129xSensor::demultiplexFrame() to get the ADS_TOTAL_CHANNELS channels of a frame.
+// 1 -> only one ADS chip (no daisy-chain). Maximum: 8 devices
+#ifndef ADS_DAISY_CHAIN_DEVICES
+#define ADS_DAISY_CHAIN_DEVICES 1
+#endif
+
+// Number of sensor objects (ADS129xSensor or ADS129xChipSensor of any model) that can be used at the same time (begin() called
+// and end() not called yet), for example, several ADS chips in cascade configuration (see page 56, section 9.4.2.1 Cascade
+// Mode, in the datasheet). Each object needs its own CS and DRDY pins. Maximum: 4
+#ifndef ADS_MAX_SENSORS
+#define ADS_MAX_SENSORS 1
+#endif
+
+// SPI clock (in Hz) used only to read the frames in RDATAC mode. No commands are sent to read a frame in this mode, so
+// the 4 MHz limit of commands doesn't apply (see Limitations in ads129xDriver.h). The maximum is 20 MHz (15 MHz if DVDD < 2.7 V,
+// see page 17, section 7.7 Switching Characteristics: Serial Interface, in the datasheet) but your board and the wires
+// between it and ADS chip may limit it more. The faster the clock, the less time the DRDY interruption takes.
+// Commands, registers and RDATA mode always use _ADS_SPI_MAX_SPEED (4 MHz).
+#ifndef ADS_SPI_FRAME_READ_SPEED
+#define ADS_SPI_FRAME_READ_SPEED 4000000 // 4 MHz. It must be an integer
+#endif
+
+// 1 -> the DRDY interruption only starts an asynchronous (DMA-like) SPI transfer of the frame into its ring buffer slot and
+// returns. The frame is published when the transfer finishes (completion callback), so the interruption is much shorter.
+// If the HAL backend can't do asynchronous transfers (for example, Arduino backend), frames are read synchronously.
+// 0 -> frames are always read synchronously inside the DRDY interruption.
+#ifndef ADS_ASYNC_FRAME_READ
+#define ADS_ASYNC_FRAME_READ 0 // 0 or 1
+#endif
+
+// 1 -> the driver measures its DRDY interruption and its SPI transactions (see ADS129xSensor::getIsrStats()): histograms of
+// the time from the DRDY edge to CS low, the time CS is low in the interruption, the time of the whole interruption and
+// the time CS is held low by your code (commands, registers, keepSpiOpen = true), and the SPI transactions and bytes.
+// It needs ~300 bytes of RAM per sensor and a few hal::micros() calls per frame.
+// 0 -> no instrumentation (no code nor RAM is used)
+#ifndef ADS_ISR_INSTRUMENTATION
+#define ADS_ISR_INSTRUMENTATION 0 // 0 or 1
+#endif
+
+// HAL used by the driver. By default, Arduino HAL is used when the code is compiled by Arduino IDE (ARDUINO is defined)
+// and the ADS chip simulator is used otherwise (ex: Linux computer for tests or benchmarks).
+#ifndef ADS_HAL_BACKEND
+#if defined(ARDUINO)
+#define ADS_HAL_BACKEND ADS_HAL_ARDUINO
+#else
+#define ADS_HAL_BACKEND ADS_HAL_HOST_SIMULATOR
+#endif
+#endif
+
 
 
 
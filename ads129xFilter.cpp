@@ -0,0 +1,91 @@
+#include "ads129xFilter.h"
+
+namespace ads {
+namespace filter {
+
+// Data rates of ADS: 32 kSPS >> i (i = 0, ..., 7)
+const uint8_t _N_DATA_RATES = 8;
+
+// Coefficients computed with the bilinear transform (RBJ Audio EQ Cookbook formulas for the notches). High-pass filters
+// have b1 = -b0, so the DC is removed exactly although the coefficients are rounded
+
+// Notch at 50 Hz with Q = 30 (-3 dB bandwidth of 1.7 Hz)
+const biquad_t NOTCH_50_HZ[_N_DATA_RATES] = {
+  {1073566165, -2147028857, 1073566165, -2147028857, 1073390506}, // 32000 SPS
+  {1073390580, -2146367348, 1073390580, -2146367348, 1073039337}, // 16000 SPS
+  {1073039702, -2144424854, 1073039702, -2144424854, 1072337579}, // 8000 SPS
+  {1072339577, -2138067825, 1072339577, -2138067825, 1070937331}, // 4000 SPS
+  {1070949600, -2115528867, 1070949600, -2115528867, 1068157376}, // 2000 SPS
+  {1068240085, -2031913388, 1068240085, -2031913388, 1062738346}, // 1000 SPS
+  {1063325044, -1720496063, 1063325044, -1720496063, 1052908265}, // 500 SPS
+  {1056987575, -653254247, 1056987575, -653254247, 1040233327}, // 250 SPS
+};
+
+// Notch at 60 Hz with Q = 30 (-3 dB bandwidth of 2 Hz)
+const biquad_t NOTCH_60_HZ[_N_DATA_RATES] = {
+  {1073531042, -2146913088, 1073531042, -2146913088, 1073320259}, // 32000 SPS
+  {1073320371, -2146044900, 1073320371, -2146044900, 1072898918}, // 16000 SPS
+  {1072899483, -2143416860, 1072899483, -2143416860, 1072057141}, // 8000 SPS
+  {1072060328, -2134604972, 1072060328, -2134604972, 1070378831}, // 4000 SPS
+  {1070398945, -2102878473, 1070398945, -2102878473, 1067056065}, // 2000 SPS
+  {1067194151, -1984504055, 1067194151, -1984504055, 1060646478}, // 1000 SPS
+  {1061629567, -1547789296, 1061629567, -1547789296, 1049517309}, // 500 SPS
+  {1056173665, -132635386, 1056173665, -132635386, 1038605506}, // 250 SPS
+};
+
+// First order high-pass with cutoff at 0.05 Hz
+const biquad_t HIGH_PASS_0_05_HZ[_N_DATA_RATES] = {
+  {1073736553, -1073736553, 0, -1073731283, 0}, // 32000 SPS
+  {1073731283, -1073731283, 0, -1073720741, 0}, // 16000 SPS
+  {1073720742, -1073720742, 0, -1073699659, 0}, // 8000 SPS
+  {1073699660, -1073699660, 0, -1073657496, 0}, // 4000 SPS
+  {1073657499, -1073657499, 0, -1073573174, 0}, // 2000 SPS
+  {1073573188, -1073573188, 0, -1073404551, 0}, // 1000 SPS
+  {1073404604, -1073404604, 0, -1073067384, 0}, // 500 SPS
+  {1073067596, -1073067596, 0, -1072393367, 0}, // 250 SPS
+};
+
+// First order high-pass with cutoff at 0.5 Hz
+const biquad_t HIGH_PASS_0_5_HZ[_N_DATA_RATES] = {
+  {1073689119, -1073689119, 0, -1073636415, 0}, // 32000 SPS
+  {1073636420, -1073636420, 0, -1073531016, 0}, // 16000 SPS
+  {1073531037, -1073531037, 0, -1073320249, 0}, // 8000 SPS
+  {1073320332, -1073320332, 0, -1072898840, 0}, // 4000 SPS
+  {1072899171, -1072899171, 0, -1072056518, 0}, // 2000 SPS
+  {1072057838, -1072057838, 0, -1070373852, 0}, // 1000 SPS
+  {1070379118, -1070379118, 0, -1067016412, 0}, // 500 SPS
+  {1067037342, -1067037342, 0, -1060332861, 0}, // 250 SPS
+};
+
+// Index of dataRate in the tables. _N_DATA_RATES if it isn't a data rate of ADS
+uint8_t _dataRateIndex(uint16_t dataRate) {
+  for (uint8_t i = 0; i < _N_DATA_RATES; i++) {
+    if ((32000U >> i) == dataRate)
+      return i;
+  }
+  return _N_DATA_RATES;
+}
+
+const biquad_t * _preset(const biquad_t *table, uint16_t dataRate) {
+  uint8_t i = _dataRateIndex(dataRate);
+  return i < _N_DATA_RATES ? &table[i] : NULL;
+}
+
+const biquad_t * notch50Hz(uint16_t dataRate) {
+  return _preset(NOTCH_50_HZ, dataRate);
+}
+
+const biquad_t * notch60Hz(uint16_t dataRate) {
+  return _preset(NOTCH_60_HZ, dataRate);
+}
+
+const biquad_t * highPass0_05Hz(uint16_t dataRate) {
+  return _preset(HIGH_PASS_0_05_HZ, dataRate);
+}
+
+const biquad_t * highPass0_5Hz(uint16_t dataRate) {
+  return _preset(HIGH_PASS_0_5_HZ, dataRate);
+}
+
+} // End of the filter namespace
+} // End of the ads namespace
@@ -0,0 +1,157 @@
+/*
+ * Fixed-point filter bank (cascade of biquads per channel) for the channels decoded from ADS129x frames. No floating
+ * point operation is done, so it's fast in boards without FPU (AVR, Cortex-M0, ...).
+ *
+ * Every section computes y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2] (direct form I) with the
+ * coefficients in Q2.30 (1.0 = 2^30, range [-2, 2)) and a 64 bits accumulator. The fraction of the accumulator that
+ * doesn't fit in the output is added to the next output (error feedback), so the rounding error doesn't grow with the
+ * gain of the poles near z = 1 (the high-pass filters of very low cutoff frequency). The samples are the int32_t codes
+ * given by the decoder (see ads129xDecoder.h) and the output has the same scale. Inside the filter bank, the codes have
+ * GUARD_BITS extra bits of resolution.
+ *
+ * Preset coefficients are given for all the data rates of CONFIG1 (250 SPS to 32 kSPS, see ads::registers::config1::dataRate()):
+ *   - Power-line notch at 50 Hz or 60 Hz.
+ *   - Baseline wander high-pass at 0.05 Hz (diagnostic ECG bandwidth) or 0.5 Hz (monitoring ECG bandwidth). They are
+ *     first order filters (as the analog ECG high-pass filters): no overshoot and the least distortion of the ST segment.
+ *
+ * Example (8 channels, 50 Hz power line, monitoring bandwidth):
+ *    ADS129xFilterBank<8> filterBank;
+ *    filterBank.addSection(ads::filter::highPass0_5Hz(sensor.getDataRate()));
+ *    filterBank.addSection(ads::filter::notch50Hz(sensor.getDataRate()));
+ *    ...
+ *    ads_frame_span_t span;
+ *    if (sensor.acquireFrames(&span)) {
+ *      filterBank.processFrames<ads_frame_traits_t>(span.frames, span.nFrames, out); // out[f * 8 + c]
+ *      sensor.releaseFrames(&span);
+ *    }
+ */
+#ifndef _ADS129X_FILTER_H_
+#define _ADS129X_FILTER_H_
+
+#include "ads129xDecoder.h"
+
+namespace ads {
+namespace filter {
+
+// The samples are multiplied by 2^GUARD_BITS inside the filter bank, so the rounding errors of the sections are much
+// smaller than one code. Codes of 24 bits use 30 bits: there is room for the overshoot of the filters and the accumulator
+// can't overflow (the sum of the absolute values of the coefficients is less than 8)
+const uint8_t GUARD_BITS = 6;
+
+// Coefficients of a section in Q2.30 (a0 is 1). First order sections have b2 = a2 = 0
+struct biquad_t {
+  int32_t b0, b1, b2, a1, a2;
+};
+
+// State of a section for one channel
+struct biquad_state_t {
+  int32_t x1, x2, y1, y2; // Last inputs and outputs
+  int32_t error; // Fraction of the accumulator (Q30) that wasn't in the last output
+};
+
+// Preset coefficients for dataRate (samples per second). NULL if dataRate isn't a data rate of ADS
+const biquad_t * notch50Hz(uint16_t dataRate);
+const biquad_t * notch60Hz(uint16_t dataRate);
+const biquad_t * highPass0_05Hz(uint16_t dataRate);
+const biquad_t * highPass0_5Hz(uint16_t dataRate);
+
+// Filter one sample
+inline int32_t biquadStep(const biquad_t &k, biquad_state_t &s, int32_t x) {
+  int64_t acc = (int64_t) k.b0 * x + (int64_t) k.b1 * s.x1 + (int64_t) k.b2 * s.x2 - (int64_t) k.a1 * s.y1 -
+                (int64_t) k.a2 * s.y2 + s.error;
+  int64_t y = acc >> 30; // Arithmetic shift: the fraction is always positive
+  s.error = (int32_t) (acc - (y << 30));
+  // Saturation (only with signals near full scale)
+  if (y > INT32_MAX)
+    y = INT32_MAX;
+  else if (y < INT32_MIN)
+    y = INT32_MIN;
+  s.x2 = s.x1;
+  s.x1 = x;
+  s.y2 = s.y1;
+  s.y1 = (int32_t) y;
+  return (int32_t) y;
+}
+
+} // End of the filter namespace
+} // End of the ads namespace
+
+/* ======= ADS129xFilterBank class definition  ============= */
+// The same cascade of up to maxSections sections for nChannels channels. Each channel has its own state
+template <uint8_t nChannels, uint8_t maxSections = 3>
+class ADS129xFilterBank {
+  private:
+    const ads::filter::biquad_t *sections[maxSections];
+    uint8_t nSections;
+    ads::filter::biquad_state_t state[nChannels][maxSections];
+
+    // Filter nFrames samples of a channel that are stride values apart
+    void processChannel(uint8_t channel, int32_t *samples, uint32_t nFrames, uint32_t stride) {
+      if (nSections == 0)
+        return;
+      for (uint32_t f = 0; f < nFrames; f++)
+        samples[f * stride] *= (1L << ads::filter::GUARD_BITS);
+      for (uint8_t i = 0; i < nSections; i++) {
+        // Coefficients and state are copied to local variables, so the compiler keeps them in registers
+        const ads::filter::biquad_t k = *sections[i];
+        ads::filter::biquad_state_t s = state[channel][i];
+        for (uint32_t f = 0; f < nFrames; f++)
+          samples[f * stride] = ads::filter::biquadStep(k, s, samples[f * stride]);
+        state[channel][i] = s;
+      }
+      // Rounded to the nearest code
+      for (uint32_t f = 0; f < nFrames; f++)
+        samples[f * stride] = (samples[f * stride] + (1L << (ads::filter::GUARD_BITS - 1))) >> ads::filter::GUARD_BITS;
+    }
+
+  public:
+    ADS129xFilterBank() {
+      nSections = 0;
+      reset();
+    }
+
+    // Add a section at the end of the cascade. Return false if coefficients is NULL (for example, a preset for a data
+    // rate that doesn't exist) or there are already maxSections sections
+    boolean addSection(const ads::filter::biquad_t *coefficients) {
+      if (coefficients == NULL || nSections == maxSections)
+        return false;
+      sections[nSections++] = coefficients;
+      return true;
+    }
+    // Remove all the sections (for example, to use the presets of a new data rate)
+    void clearSections() {
+      nSections = 0;
+      reset();
+    }
+    // Clear the state of all channels (for example, after a gap in the samples)
+    void reset() {
+      for (uint8_t c = 0; c < nChannels; c++) {
+        for (uint8_t i = 0; i < maxSections; i++) {
+          ads::filter::biquad_state_t &s = state[c][i];
+          s.x1 = s.x2 = s.y1 = s.y2 = s.error = 0;
+        }
+      }
+    }
+
+    // Filter in place nFrames frames with the per-channel layout: columns[c * stride + f] (see decodeFramesToColumns()).
+    // It's the fastest layout: every channel is filtered through all the sections one after another
+    void processColumns(int32_t *columns, uint32_t nFrames, uint32_t stride) {
+      for (uint8_t c = 0; c < nChannels; c++)
+        processChannel(c, columns + c * stride, nFrames, 1);
+    }
+    // Filter in place nFrames frames with the frame by frame layout: samples[f * nChannels + c] (see decodeFrames())
+    void processInterleaved(int32_t *samples, uint32_t nFrames) {
+      for (uint8_t c = 0; c < nChannels; c++)
+        processChannel(c, samples + c, nFrames, nChannels);
+    }
+    // Decode nFrames frames (for example, the frames of a span of the ring buffer) and filter them: out[f * nChannels + c].
+    // Frame::TOTAL_CHANNELS must be nChannels
+    template <class Frame>
+    void processFrames(const typename Frame::data_t *frames, uint32_t nFrames, int32_t *out) {
+      static_assert(Frame::TOTAL_CHANNELS == nChannels, "The frames must have nChannels channels");
+      ads::decoder::decodeFrames<Frame>(frames, nFrames, out);
+      processInterleaved(out, nFrames);
+    }
+};
+
+#endif /* _ADS129X_FILTER_H_ */
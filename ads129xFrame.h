@@ -0,0 +1,147 @@
+/*
+ * Compile-time description of the ADS chip models and of the frames that they send.
+ *
+ * ads129xDriverConfig.h selects one chip model and one number of bits per channel for ADS129xSensor (ads_data_t and
+ * the other types in ads129xDriver.h are aliases of the types defined here for that model). These templates let
+ * you use the frames of any other model in the same program: ADS129xChipSensor<chip, bits> (see ads129xDriver.h)
+ * drives a chip of any model with them, and a gateway that receives frames from ADS1294R and ADS1298 boards can
+ * decode both:
+ *
+ *    typedef ads::frame_traits<ADS_1294R, 24> ads1294rFrame;
+ *    typedef ads::frame_traits<ADS_1298, 24> ads1298Frame;
+ *    ads1298Frame::data_t frames[64];
+ *    ...
+ *    ads::decoder::decodeFrames<ads1298Frame>(frames, 64, out); // See ads129xDecoder.h
+ *
+ * Every value is a compile-time constant, so code specialized for a model doesn't have any runtime branch.
+ */
+#ifndef _ADS129X_FRAME_H_
+#define _ADS129X_FRAME_H_
+
+#include "ads129xDatasheetConstants.h"
+
+namespace ads {
+
+/* ======= Chip models ============= */
+// chip is one of the ADS supported chips defines (ADS_1294, ADS_1294R, ...) of ads129xDriverConfig.h
+template <uint8_t chip> struct chip_traits;
+
+template <> struct chip_traits<ADS_1294> {
+  static constexpr uint8_t N_CHANNELS = 4;
+  static constexpr bool HAS_RESPIRATION_MODULE = false;
+  static constexpr byte ID = registers::id::ID_ADS1294;
+};
+
+template <> struct chip_traits<ADS_1294R> {
+  static constexpr uint8_t N_CHANNELS = 4;
+  static constexpr bool HAS_RESPIRATION_MODULE = true;
+  static constexpr byte ID = registers::id::ID_ADS1294R;
+};
+
+template <> struct chip_traits<ADS_1296> {
+  static constexpr uint8_t N_CHANNELS = 6;
+  static constexpr bool HAS_RESPIRATION_MODULE = false;
+  static constexpr byte ID = registers::id::ID_ADS1296;
+};
+
+template <> struct chip_traits<ADS_1296R> {
+  static constexpr uint8_t N_CHANNELS = 6;
+  static constexpr bool HAS_RESPIRATION_MODULE = true;
+  static constexpr byte ID = registers::id::ID_ADS1296R;
+};
+
+template <> struct chip_traits<ADS_1298> {
+  static constexpr uint8_t N_CHANNELS = 8;
+  static constexpr bool HAS_RESPIRATION_MODULE = false;
+  static constexpr byte ID = registers::id::ID_ADS1298;
+};
+
+template <> struct chip_traits<ADS_1298R> {
+  static constexpr uint8_t N_CHANNELS = 8;
+  static constexpr bool HAS_RESPIRATION_MODULE = true;
+  static constexpr byte ID = registers::id::ID_ADS1298R;
+};
+
+/* ======= Frames ============= */
+// One channel sample (big-endian binary two's complement)
+template <uint8_t bits> struct bits_sample_t;
+
+template <> struct bits_sample_t<16> {
+  uint8_t hi, low;
+};
+
+template <> struct bits_sample_t<24> {
+  uint8_t hi, mid, low;
+};
+
+// Frame sent by nDevices chips of the same model in daisy-chain (1 if there isn't daisy-chain) with bits per channel
+template <uint8_t chip, uint8_t bits, uint8_t nDevices = 1>
+struct frame_traits {
+  static constexpr uint8_t CHIP = chip;
+  static constexpr uint8_t N_CHANNELS = chip_traits<chip>::N_CHANNELS;
+  static constexpr uint8_t BITS_PER_CHANNEL = bits;
+  static constexpr uint8_t N_DEVICES = nDevices;
+  static constexpr uint8_t TOTAL_CHANNELS = nDevices * N_CHANNELS;
+  // 24 status bits + bits per channel x number of channels
+  static constexpr uint16_t DEVICE_PACKAGE_SIZE = 3 + bits / 8 * N_CHANNELS;
+  static constexpr uint16_t PACKAGE_SIZE = nDevices * DEVICE_PACKAGE_SIZE;
+
+  typedef bits_sample_t<bits> sample_t;
+
+  // Data sent by one chip
+  struct device_data_t {
+    byte statusWord[3];
+    sample_t channel[N_CHANNELS];
+  };
+
+  // Data sent by all the chips (see ads_data_t in ads129xDriver.h)
+  union data_t {
+    byte rawData[PACKAGE_SIZE];
+    device_data_t formatedData; // Data of the first device
+    device_data_t device[nDevices];
+  };
+};
+
+// The same frame stored in slots of slotSize bytes (the bytes after PACKAGE_SIZE aren't used). With ADS_RUNTIME_FRAME_WIDTH
+// (see ads129xDriverConfig.h), 16 bits frames are stored in the slots of 24 bits frames: the decoders of ads129xDecoder.h
+// use data_t to find the next frame, so they decode these slots without any copy
+template <uint8_t chip, uint8_t bits, uint8_t nDevices, uint16_t slotSize>
+struct slot_frame_traits : frame_traits<chip, bits, nDevices> {
+  static_assert(slotSize >= frame_traits<chip, bits, nDevices>::PACKAGE_SIZE, "The frame doesn't fit in the slot");
+  typedef typename frame_traits<chip, bits, nDevices>::device_data_t device_data_t;
+
+  union data_t {
+    byte rawData[slotSize];
+    device_data_t formatedData;
+    device_data_t device[nDevices];
+  };
+};
+
+/* ======= Status word ============= */
+// 24 bits: 1100 + LOFF_STATP + LOFF_STATN + bits[7:4] of GPIO register. See page 53, section 9.4.1.3.1 Status Word,
+// in the datasheet
+struct status_t {
+  byte loffStatp; // The same bits than LOFF_STATP register (1 -> lead-off of the positive input of the channel)
+  byte loffStatn; // The same bits than LOFF_STATN register (1 -> lead-off of the negative input of the channel)
+  byte gpio; // GPIO data bits: bit 0 is GPIO1, ..., bit 3 is GPIO4
+};
+
+const byte STATUS_SYNC_MASK = 0xF0;
+const byte STATUS_SYNC = 0xC0; // 1100 in the first 4 bits
+
+// The first 4 bits are 1100. Otherwise, the frame wasn't read correctly
+inline bool isStatusWordValid(const byte *statusWord) {
+  return (statusWord[0] & STATUS_SYNC_MASK) == STATUS_SYNC;
+}
+
+inline status_t decodeStatusWord(const byte *statusWord) {
+  status_t status;
+  status.loffStatp = (statusWord[0] << 4) | (statusWord[1] >> 4);
+  status.loffStatn = (statusWord[1] << 4) | (statusWord[2] >> 4);
+  status.gpio = statusWord[2] & 0x0F;
+  return status;
+}
+
+} // End of the ads namespace
+
+#endif /* _ADS129X_FRAME_H_ */
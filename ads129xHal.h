@@ -0,0 +1,110 @@
+/*
+ * Hardware abstraction layer (HAL) used by ADS129xSensor.
+ *
+ * The driver never calls SPI, pins, interrupts or time functions directly. It uses the functions declared
+ * in this file, so it can be compiled and exercised outside of an Arduino board. The backend is selected with 
+ * ADS_HAL_BACKEND (see ads129xDriverConfig.h):
+ *    - ADS_HAL_ARDUINO: Arduino SPI library and Arduino core functions (ads129xHalArduino.cpp).
+ *    - ADS_HAL_HOST_SIMULATOR: host computer. Every function talks to an ADS chip simulator 
+ *      (extras/simulator/ads129xHalHost.cpp and extras/simulator/ads129xChipSimulator.h).
+ *    - ADS_HAL_HOST_MOCK: host computer. SPI answers with fixed bytes and takes no time, so only the code of the
+ *      driver is measured (extras/benchmark/ads129xHalMock.cpp).
+ *    - ADS_HAL_LINUX: Linux computer or gateway. SPI through /dev/spidev and pins through the GPIO character device,
+ *      with a reader thread as interrupt context (extras/linux/ads129xHalLinux.cpp and extras/linux/ads129xHalLinux.h).
+ *
+ * When a backend different from Arduino is used, this file also defines the few Arduino types and
+ * constants used by the library (byte, boolean, HIGH, LOW, ...).
+ *
+ * The chip select pin is handled by the backend inside spiBeginTransaction/spiEndTransaction because some
+ * backends don't control it with a GPIO pin.
+ */
+#ifndef _ADS129X_HAL_H_
+#define _ADS129X_HAL_H_
+
+#include "ads129xDriverConfig.h"
+
+#if ADS_HAL_BACKEND == ADS_HAL_ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#ifndef HIGH
+#define HIGH 0x1
+#define LOW 0x0
+#endif
+#ifndef NULL
+#define NULL 0
+#endif
+#endif
+
+namespace ads {
+namespace hal {
+
+/* ======= SPI ============= */
+void spiBegin();
+// Configure the SPI bus (mode 1, MSB first and clockHz) and put the chip select pin in LOW. If the transaction of an
+// asynchronous transfer (see spiTransferAsync()) is open, wait until its completion interruption closes it: the check
+// and the new transaction are atomic for the backend, so no transfer can start between them. It mustn't be called from
+// interrupt context while that transaction is open (it would wait forever)
+void spiBeginTransaction(uint8_t chipSelectPin, uint32_t clockHz);
+// Put the chip select pin in HIGH and release the SPI bus
+void spiEndTransaction(uint8_t chipSelectPin);
+// Send data and return the byte received at the same time
+byte spiTransfer(byte data);
+// Send nBytes from buffer and overwrite them with the bytes received
+void spiTransfer(byte *buffer, uint16_t nBytes);
+// Send nBytes from data and ignore the bytes received. The backend can queue them until the next function that receives
+// bytes or the end of the transaction, so several commands are sent together (for example, one system call in Linux)
+void spiWrite(const byte *data, uint16_t nBytes);
+// Send nBytes zeros and store the bytes received in buffer (its previous content isn't sent, so it doesn't need to be cleared)
+void spiReceive(byte *buffer, uint16_t nBytes);
+// Start an asynchronous (DMA or similar) transfer of nBytes inside the open transaction and return immediately. Zeros are
+// sent and the bytes received are stored in buffer. onComplete is called from interrupt context (or another thread in host
+// backends) when the transfer finishes. Return false if the backend can't do asynchronous transfers (nothing is done).
+boolean spiTransferAsync(byte *buffer, uint16_t nBytes, void (*onComplete)());
+
+/* ======= GPIO pins ============= */
+void setPinAsOutput(uint8_t pin);
+void setPinAsInput(uint8_t pin);
+void writePin(uint8_t pin, uint8_t level); // level: HIGH or LOW
+
+/* ======= Interrupts ============= */
+// On host backends, disabling interrupts also blocks the threads that emulate interrupt context
+// isr is called when DRDY pin falls. The interruption is not called while a SPI transaction is open (it's
+// called when the transaction ends)
+void attachDrdyInterrupt(uint8_t drdyPin, void (*isr)());
+void detachDrdyInterrupt(uint8_t drdyPin);
+void disableInterrupts();
+void enableInterrupts();
+
+/* ======= Time ============= */
+// Inside a SPI transaction with queued bytes (see spiWrite()), the backend can do the delay between the queued bytes and
+// the next ones instead of waiting now
+void delayMs(uint32_t ms);
+void delayUs(uint32_t us);
+uint32_t micros();
+
+/* ======= Messages (used when ADS_LIBRARY_VERBOSE_LEVEL > 0) ============= */
+void print(const char *msg);
+void println(const char *msg);
+void println(uint32_t value, uint8_t base);
+// Stop program execution. Called after an error
+void halt();
+
+} // End of the hal namespace
+} // End of the ads namespace
+
+// Avoid that memory accesses are moved across this point (by the compiler or by the CPU). In Arduino boards (one core),
+// a compiler barrier is enough. In host backends, interrupt context is emulated with threads, so a full fence is needed.
+#if ADS_HAL_BACKEND == ADS_HAL_ARDUINO
+#define _ADS_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define _ADS_MEMORY_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#endif /* _ADS129X_HAL_H_ */
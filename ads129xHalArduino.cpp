@@ -0,0 +1,131 @@
+// Arduino backend of the hardware abstraction layer. See ads129xHal.h
+#include "ads129xDriver.h"
+
+#if ADS_HAL_BACKEND == ADS_HAL_ARDUINO
+
+#include <SPI.h>
+
+namespace ads {
+namespace hal {
+
+/* ======= SPI ============= */
+void spiBegin() {
+  SPI.begin();
+}
+
+// See page 17, section 7.7 Switching Characteristics: Serial Interface, and page 59, section 9.5 Programming, in the datasheet) to understand SPI communication
+void spiBeginTransaction(uint8_t chipSelectPin, uint32_t clockHz) {
+  // Delays aren't need because Arduino is slow enough to execute beginTransaction and endTransaction functions
+  SPI.beginTransaction(SPISettings(clockHz, _ADS_SPI_BIT_ORDER, _ADS_SPI_MODE));
+  digitalWrite(chipSelectPin, LOW);
+  // delayMicroseconds(_ADS_T_CSSC);
+}
+
+void spiEndTransaction(uint8_t chipSelectPin) {
+  // Delays aren't need because Arduino is slow enough to execute beginTransaction and endTransaction functions
+  // delayMicroseconds(_ADS_T_SCCS);
+  digitalWrite(chipSelectPin, HIGH);
+  // delayMicroseconds(_ADS_T_CSH);
+  SPI.endTransaction();
+}
+
+byte spiTransfer(byte data) {
+  return SPI.transfer(data);
+}
+
+void spiTransfer(byte *buffer, uint16_t nBytes) {
+  SPI.transfer((void*) buffer, nBytes);
+}
+
+void spiWrite(const byte *data, uint16_t nBytes) {
+  for (uint16_t i = 0; i < nBytes; i++)
+    SPI.transfer(data[i]);
+}
+
+// The buffer version of SPI.transfer() would need a pass to clear the buffer. Most of the cores implement it with a
+// loop of one byte transfers, so this loop is as fast as it
+void spiReceive(byte *buffer, uint16_t nBytes) {
+  for (uint16_t i = 0; i < nBytes; i++)
+    buffer[i] = SPI.transfer(0x00);
+}
+
+// Arduino SPI library doesn't offer asynchronous transfers -> the driver reads the frames synchronously
+boolean spiTransferAsync(byte *buffer, uint16_t nBytes, void (*onComplete)()) {
+  (void) buffer;
+  (void) nBytes;
+  (void) onComplete;
+  return false;
+}
+
+/* ======= GPIO pins ============= */
+void setPinAsOutput(uint8_t pin) {
+  pinMode(pin, OUTPUT);
+}
+
+void setPinAsInput(uint8_t pin) {
+  pinMode(pin, INPUT);
+}
+
+void writePin(uint8_t pin, uint8_t level) {
+  digitalWrite(pin, level);
+}
+
+/* ======= Interrupts ============= */
+void attachDrdyInterrupt(uint8_t drdyPin, void (*isr)()) {
+  attachInterrupt(digitalPinToInterrupt(drdyPin), isr, FALLING);
+  SPI.usingInterrupt(digitalPinToInterrupt(drdyPin)); // Disable the interrupt when there is a SPI transaction in course
+}
+
+void detachDrdyInterrupt(uint8_t drdyPin) {
+  SPI.notUsingInterrupt(digitalPinToInterrupt(drdyPin));
+  detachInterrupt(digitalPinToInterrupt(drdyPin));
+}
+
+void disableInterrupts() {
+  noInterrupts();
+}
+
+void enableInterrupts() {
+  interrupts();
+}
+
+/* ======= Time ============= */
+void delayMs(uint32_t ms) {
+  delay(ms);
+}
+
+void delayUs(uint32_t us) {
+  delayMicroseconds(us);
+}
+
+uint32_t micros() {
+  return ::micros();
+}
+
+/* ======= Messages ============= */
+void print(const char *msg) {
+#if ADS_LIBRARY_VERBOSE_LEVEL > 0
+  Serial.print(msg);
+#endif
+}
+
+void println(const char *msg) {
+#if ADS_LIBRARY_VERBOSE_LEVEL > 0
+  Serial.println(msg);
+#endif
+}
+
+void println(uint32_t value, uint8_t base) {
+#if ADS_LIBRARY_VERBOSE_LEVEL > 0
+  Serial.println(value, base);
+#endif
+}
+
+void halt() {
+  while (1);
+}
+
+} // End of the hal namespace
+} // End of the ads namespace
+
+#endif /* ADS_HAL_BACKEND == ADS_HAL_ARDUINO */
@@ -0,0 +1,133 @@
+#include "ads129xProfile.h"
+#include "ads129xRecording.h"
+
+#include <stddef.h>
+#include <string.h>
+
+namespace ads {
+namespace profile {
+
+using namespace ads::registers;
+
+// Reserved bits that must be written as 1, by register address (see ads129xDatasheetConstants.h)
+static const byte _RESERVED_BITS[N_REGISTERS] = {
+  id::RESERVED_BITS, config1::RESERVED_BITS, config2::RESERVED_BITS, config3::RESERVED_BITS, loff::RESERVED_BITS,
+  chnSet::RESERVED_BITS, chnSet::RESERVED_BITS, chnSet::RESERVED_BITS, chnSet::RESERVED_BITS,
+  chnSet::RESERVED_BITS, chnSet::RESERVED_BITS, chnSet::RESERVED_BITS, chnSet::RESERVED_BITS,
+  rldSensp::RESERVED_BITS, rldSensn::RESERVED_BITS, loffSensp::RESERVED_BITS, loffSensn::RESERVED_BITS, loffFlip::RESERVED_BITS,
+  loffStatp::RESERVED_BITS, loffStatn::RESERVED_BITS,
+  gpio::RESERVED_BITS, pace::RESERVED_BITS, resp::RESERVED_BITS, config4::RESERVED_BITS, wct1::RESERVED_BITS, wct2::RESERVED_BITS
+};
+
+static boolean _isWritable(uint8_t addr) {
+  return addr != id::REG_ADDR && addr != loffStatp::REG_ADDR && addr != loffStatn::REG_ADDR;
+}
+
+template <uint8_t chip>
+void setResetValues(ads_profile_t &profile) {
+  memset(&profile, 0, sizeof(profile));
+  profile.version = VERSION;
+  profile.registers[id::REG_ADDR] = ads::chip_traits<chip>::ID;
+  profile.registers[config1::REG_ADDR] = config1::RESET_VALUE;
+  profile.registers[config2::REG_ADDR] = config2::RESET_VALUE;
+  profile.registers[config3::REG_ADDR] = config3::RESET_VALUE;
+  profile.registers[loff::REG_ADDR] = loff::RESET_VALUE;
+  for (uint8_t i = 1; i <= 8; i++)
+    profile.registers[chnSet::_BASE_REG_ADDR + i] = chnSet::RESET_VALUE;
+  profile.registers[rldSensp::REG_ADDR] = rldSensp::RESET_VALUE;
+  profile.registers[rldSensn::REG_ADDR] = rldSensn::RESET_VALUE;
+  profile.registers[loffSensp::REG_ADDR] = loffSensp::RESET_VALUE;
+  profile.registers[loffSensn::REG_ADDR] = loffSensn::RESET_VALUE;
+  profile.registers[loffFlip::REG_ADDR] = loffFlip::RESET_VALUE;
+  profile.registers[gpio::REG_ADDR] = gpio::RESET_VALUE;
+  profile.registers[pace::REG_ADDR] = pace::RESET_VALUE;
+  profile.registers[resp::REG_ADDR] = resp::RESET_VALUE;
+  profile.registers[config4::REG_ADDR] = config4::RESET_VALUE;
+  profile.registers[wct1::REG_ADDR] = wct1::RESET_VALUE;
+  profile.registers[wct2::REG_ADDR] = wct2::RESET_VALUE;
+}
+
+template <uint8_t chip, uint8_t bits>
+void capture(ADS129xChipSensor<chip, bits> &sensor, ads_profile_t &profile) {
+  memset(&profile, 0, sizeof(profile));
+  profile.version = VERSION;
+  for (uint8_t addr = 0; addr < N_REGISTERS; addr++)
+    profile.registers[addr] = _isWritable(addr) || addr == id::REG_ADDR ? sensor.getRegisterShadow(addr) : 0;
+}
+
+template <uint8_t chip, uint8_t bits>
+boolean apply(ADS129xChipSensor<chip, bits> &sensor, const ads_profile_t &profile, boolean keepSpiOpen) {
+  if (profile.version != VERSION || profile.registers[id::REG_ADDR] != ads::chip_traits<chip>::ID)
+    return false;
+
+  // Only the registers that change are dirty in the shadow -> they are written in as few WREG commands as possible
+  for (uint8_t addr = 0; addr < N_REGISTERS; addr++) {
+    if (_isWritable(addr))
+      sensor.setRegisterShadow(addr, profile.registers[addr] | _RESERVED_BITS[addr]);
+  }
+  sensor.flushRegisters(keepSpiOpen);
+  return true;
+}
+
+template <uint8_t chip, uint8_t bits>
+uint32_t verify(ADS129xChipSensor<chip, bits> &sensor, const ads_profile_t &profile, boolean keepSpiOpen) {
+  byte registers[N_REGISTERS];
+  sensor.readAllRegisters(registers, keepSpiOpen);
+
+  uint32_t differentRegisters = 0;
+  for (uint8_t addr = 0; addr < N_REGISTERS; addr++) {
+    if (!_isWritable(addr) && addr != id::REG_ADDR)
+      continue;
+    byte mask = 0xFF;
+    // GPIOD bits of inputs (GPIOC bit = 1) are set by the pins
+    if (addr == gpio::REG_ADDR)
+      mask = ~((profile.registers[addr] & 0x0F) << 4);
+    if (((profile.registers[addr] | _RESERVED_BITS[addr]) ^ registers[addr]) & mask)
+      differentRegisters |= (uint32_t) 1 << addr;
+  }
+  return differentRegisters;
+}
+
+void serialize(const ads_profile_t &profile, byte *bytes) {
+  ads_profile_t sealed = profile;
+  sealed.crc = ads::recording::crc32(&sealed, offsetof(ads_profile_t, crc));
+  memcpy(bytes, &sealed, SIZE);
+}
+
+boolean deserialize(const byte *bytes, ads_profile_t &profile) {
+  ads_profile_t copy;
+  memcpy(&copy, bytes, SIZE);
+  if (copy.version != VERSION || copy.crc != ads::recording::crc32(&copy, offsetof(ads_profile_t, crc)))
+    return false;
+  profile = copy;
+  return true;
+}
+
+/* ======= Profiles of every chip model  ============= */
+// Like the sensors (see the end of ads129xDriver.cpp), the functions of all chip models are compiled here
+#define _ADS_PROFILE_FUNCTIONS(chip, bits) \
+  template void capture<chip, bits>(ADS129xChipSensor<chip, bits> &, ads_profile_t &); \
+  template boolean apply<chip, bits>(ADS129xChipSensor<chip, bits> &, const ads_profile_t &, boolean); \
+  template uint32_t verify<chip, bits>(ADS129xChipSensor<chip, bits> &, const ads_profile_t &, boolean);
+
+// With ADS_RUNTIME_FRAME_WIDTH, there are only sensors of 24 bits frames
+#if ADS_RUNTIME_FRAME_WIDTH
+#define _ADS_PROFILE_FUNCTIONS_16(chip)
+#else
+#define _ADS_PROFILE_FUNCTIONS_16(chip) _ADS_PROFILE_FUNCTIONS(chip, 16)
+#endif
+
+#define _ADS_PROFILES_OF_CHIP(chip) \
+  template void setResetValues<chip>(ads_profile_t &); \
+  _ADS_PROFILE_FUNCTIONS(chip, 24) \
+  _ADS_PROFILE_FUNCTIONS_16(chip)
+
+_ADS_PROFILES_OF_CHIP(ADS_1294)
+_ADS_PROFILES_OF_CHIP(ADS_1294R)
+_ADS_PROFILES_OF_CHIP(ADS_1296)
+_ADS_PROFILES_OF_CHIP(ADS_1296R)
+_ADS_PROFILES_OF_CHIP(ADS_1298)
+_ADS_PROFILES_OF_CHIP(ADS_1298R)
+
+} // End of the profile namespace
+} // End of the ads namespace
@@ -0,0 +1,79 @@
+/*
+ * Configuration profiles: the whole register map of ADS129x in 32 bytes, so a configuration (resting ECG, stress test,
+ * impedance, ...) can be a constant of your program, be stored in flash/EEPROM or be sent over a link, and it's applied
+ * with a few SPI bursts instead of a sequence of writeRegister(), enableChannelAndSetGain(), ... calls.
+ *
+ * Layout (32 bytes, numbers are little-endian like in ads129xRecording.h):
+ *    byte 0       version (ads::profile::VERSION)
+ *    bytes 1-26   registers[i] is the register with address i (ID to WCT2). registers[0] is the ID of the chip model and
+ *                 LOFF_STATP and LOFF_STATN (read-only) aren't used
+ *    byte 27      reserved (0)
+ *    bytes 28-31  CRC-32 of the previous bytes (see ads::recording::crc32()). Only needed when the profile is stored or
+ *                 sent: use serialize() and deserialize()
+ *
+ * A profile can be built at compile time with the constants of ads129xDatasheetConstants.h (the CRC isn't needed):
+ *    using namespace ads::registers;
+ *    const ads_profile_t RESTING_ECG = {ads::profile::VERSION, {
+ *      ads::chip_traits<ADS_CHIP_USED>::ID,
+ *      config1::HIGH_RES_500_SPS, config2::TEST_FREQ_2HZ, config3::B_PD_REFBUF | config3::RESERVED_BITS, loff::RESET_VALUE,
+ *      chnSet::GAIN_6X, chnSet::GAIN_6X, chnSet::DISABLE_CHANNEL | chnSet::SHORTED, chnSet::DISABLE_CHANNEL | chnSet::SHORTED,
+ *      chnSet::RESET_VALUE, chnSet::RESET_VALUE, chnSet::RESET_VALUE, chnSet::RESET_VALUE, // CH5SET to CH8SET
+ *      rldSensp::RESET_VALUE, rldSensn::RESET_VALUE, loffSensp::RESET_VALUE, loffSensn::RESET_VALUE, loffFlip::RESET_VALUE,
+ *      0, 0, // LOFF_STATP and LOFF_STATN
+ *      gpio::RESET_VALUE, pace::RESET_VALUE, resp::RESET_VALUE, config4::RESET_VALUE, wct1::RESET_VALUE, wct2::RESET_VALUE}};
+ *    ...
+ *    ads::profile::apply(sensor, RESTING_ECG); // ADS mustn't be in RDATAC mode
+ *    if (ads::profile::verify(sensor, RESTING_ECG) != 0)
+ *      ... // Some registers weren't written
+ * Or from the current configuration: configure ADS with the methods of ADS129xSensor and capture() it.
+ *
+ * The functions follow the chip model of the sensor (ADS129xSensor or any ADS129xChipSensor<chip, bits>): a profile
+ * only applies to a sensor of the model of its ID register. setResetValues<chip>() builds the profile of other models
+ * than ADS_CHIP_USED.
+ */
+#ifndef _ADS129X_PROFILE_H_
+#define _ADS129X_PROFILE_H_
+
+#include "ads129xDriver.h"
+
+typedef struct {
+  uint8_t version; // ads::profile::VERSION
+  byte registers[ads::registers::N_REGISTERS]; // registers[i] is the register with address i. registers[0]: ID of the chip model
+  byte reserved; // 0
+  uint32_t crc; // CRC-32 of the previous bytes (set by serialize())
+} ads_profile_t;
+static_assert(sizeof(ads_profile_t) == 32, "The profiles must have 32 bytes");
+
+namespace ads {
+namespace profile {
+
+const uint8_t VERSION = 1;
+const uint8_t SIZE = sizeof(ads_profile_t);
+
+// Profile of the chip model with the register values after a reset
+template <uint8_t chip = ADS_CHIP_USED>
+void setResetValues(ads_profile_t &profile);
+// Copy the register shadow of the sensor (no SPI communication is done, so it can be called in RDATAC mode)
+template <uint8_t chip, uint8_t bits>
+void capture(ADS129xChipSensor<chip, bits> &sensor, ads_profile_t &profile);
+// Write the registers of the profile that are different from the register shadow of the sensor. Consecutive registers
+// are written with one WREG command and all of them in one SPI transaction (see ADS129xSensor::flushRegisters()). The
+// reserved bits that must be 1 are added. Return false (and nothing is written) if the version is wrong or the chip
+// model of the profile isn't the one of the sensor. ADS mustn't be in RDATAC mode
+template <uint8_t chip, uint8_t bits>
+boolean apply(ADS129xChipSensor<chip, bits> &sensor, const ads_profile_t &profile, boolean keepSpiOpen = false);
+// Read the whole register map with one RREG command and compare it with the profile. Return the registers that are
+// different (bit i is 1 -> register with address i), so 0 means that the profile is applied. The data bits of the GPIO
+// pins that are inputs aren't compared. ADS mustn't be in RDATAC mode
+template <uint8_t chip, uint8_t bits>
+uint32_t verify(ADS129xChipSensor<chip, bits> &sensor, const ads_profile_t &profile, boolean keepSpiOpen = false);
+
+// Copy the profile in bytes (SIZE bytes) with its CRC
+void serialize(const ads_profile_t &profile, byte *bytes);
+// Copy SIZE bytes written by serialize() in profile. Return false if the CRC or the version are wrong
+boolean deserialize(const byte *bytes, ads_profile_t &profile);
+
+} // End of the profile namespace
+} // End of the ads namespace
+
+#endif /* _ADS129X_PROFILE_H_ */
@@ -0,0 +1,228 @@
+#include "ads129xQrsDetector.h"
+
+#include <string.h>
+
+namespace ads {
+namespace qrs {
+
+// Number of samples of t seconds (t in hundredths of a second) at rate samples per second, rounded
+static uint16_t _samples(uint16_t rate, uint16_t hundredths) {
+  return ((uint32_t) rate * hundredths + 50) / 100;
+}
+
+// floor(log2(n))
+static uint8_t _log2(uint16_t n) {
+  uint8_t bits = 0;
+  while (n >>= 1)
+    bits++;
+  return bits;
+}
+
+boolean setParams(params_t &params, uint16_t dataRate) {
+  // Faster rates would need a decimation that doesn't fit in params.decimation
+  if (dataRate < MIN_DATA_RATE || dataRate > MAX_DATA_RATE)
+    return false;
+
+  // Internal rate in [250, 500) SPS or the data rate if it's lower
+  params.decimation = dataRate >= 500 ? dataRate / 250 : 1;
+  params.rate = dataRate / params.decimation;
+  params.lowPassLength = _samples(params.rate, 3);
+  params.lowPassShift = _log2(params.lowPassLength);
+  params.highPassLength = _samples(params.rate, 16) | 1; // Odd, so the center sample exists
+  params.highPassShift = _log2(params.highPassLength);
+  params.derivativeStep = (params.rate + 100) / 200; // 5 ms steps as the 5-point derivative of Pan-Tompkins at 200 SPS
+  params.integrationLength = _samples(params.rate, 15);
+  params.bandPassDelay = (params.lowPassLength - 1) + (params.highPassLength - 1) / 2;
+  params.settleLength = 2 * params.lowPassLength + params.highPassLength + 4 * params.derivativeStep + params.integrationLength;
+  params.refractoryLength = _samples(params.rate, 20);
+  params.tWaveLength = _samples(params.rate, 36);
+  params.learningLength = 2 * params.rate;
+  return true;
+}
+
+void resetLead(lead_t &lead) {
+  memset(&lead, 0, sizeof(lead));
+}
+
+uint64_t filterLead(lead_t &lead, const params_t &params, int32_t x, int32_t &bandPass) {
+  // Low-pass: two moving sums (triangular window). Every sum is divided by a power of 2 near its length
+  uint8_t i = lead.lowPassIndex;
+  lead.lowPass1Sum += x - lead.lowPass1[i];
+  lead.lowPass1[i] = x;
+  int32_t lowPass = lead.lowPass1Sum >> params.lowPassShift;
+  lead.lowPass2Sum += lowPass - lead.lowPass2[i];
+  lead.lowPass2[i] = lowPass;
+  lowPass = lead.lowPass2Sum >> params.lowPassShift;
+  lead.lowPassIndex = i + 1 < params.lowPassLength ? i + 1 : 0;
+
+  // High-pass: center sample of the window minus the average of the window
+  i = lead.highPassIndex;
+  lead.highPassSum += lowPass - lead.highPass[i];
+  lead.highPass[i] = lowPass;
+  lead.highPassIndex = i + 1 < params.highPassLength ? i + 1 : 0;
+  uint8_t center = i >= params.highPassLength / 2 ? i - params.highPassLength / 2 : i + params.highPassLength - params.highPassLength / 2;
+  bandPass = (int32_t) (((int64_t) lead.highPass[center] * params.highPassLength - lead.highPassSum) >> params.highPassShift);
+
+  // Derivative: (2 x[n] + x[n - s] - x[n - 3 s] - 2 x[n - 4 s]) / 8
+  const uint8_t length = 4 * params.derivativeStep + 1;
+  i = lead.derivativeIndex;
+  lead.derivative[i] = bandPass;
+  lead.derivativeIndex = i + 1 < length ? i + 1 : 0;
+  const int32_t *d = lead.derivative;
+  const uint8_t s = params.derivativeStep;
+  int32_t derivative = (2 * d[i] + d[(i + length - s) % length] - d[(i + length - 3 * s) % length] - 2 * d[(i + 1) % length]) >> 3;
+  return (uint64_t) ((int64_t) derivative * derivative);
+}
+
+void resetDetector(detector_t &detector, const params_t &params, boolean learnThresholds) {
+  memset(detector.integration, 0, sizeof(detector.integration));
+  detector.integrationSum = 0;
+  detector.lastIntegration = 0;
+  detector.integrationIndex = 0;
+  detector.settleLeft = params.settleLength;
+  detector.rising = false;
+  detector.peakValue = 0;
+  detector.energyMax = 0;
+  detector.bandPassMax = 0;
+  detector.searchBackValue = 0;
+  detector.isRrValid = false; // The first RR interval after a gap would include the gap
+  if (!learnThresholds)
+    return;
+
+  detector.t = 0;
+  detector.learningLeft = params.learningLength;
+  detector.learningMax = 0;
+  detector.signalLevel = 0;
+  detector.noiseLevel = 0;
+  detector.hasBeat = false;
+  detector.rrSum = 0;
+  detector.rrCount = 0;
+  detector.rrIndex = 0;
+  detector.beatHead = 0;
+  detector.beatTail = 0;
+}
+
+static void _addBeat(detector_t &detector, uint32_t t, uint32_t sampleIndex, uint64_t energy, boolean searchBack) {
+  if (detector.hasBeat && detector.isRrValid) {
+    uint32_t rr = t - detector.lastBeatT;
+    if (rr > 0xFFFF)
+      rr = 0xFFFF;
+    if (detector.rrCount == _RR_INTERVALS)
+      detector.rrSum -= detector.rr[detector.rrIndex];
+    else
+      detector.rrCount++;
+    detector.rr[detector.rrIndex] = rr;
+    detector.rrSum += rr;
+    detector.rrIndex = (detector.rrIndex + 1) % _RR_INTERVALS;
+  }
+
+  uint8_t nextHead = (detector.beatHead + 1) & _BEAT_BUFFER_MASK;
+  if (nextHead != detector.beatTail) { // Beats are lost if they aren't read
+    ads_beat_t &beat = detector.beats[detector.beatHead];
+    beat.sampleIndex = sampleIndex;
+    beat.rrSamples = detector.hasBeat && detector.isRrValid ? sampleIndex - detector.lastBeatSampleIndex : 0;
+    beat.searchBack = searchBack;
+    detector.beatHead = nextHead;
+  }
+
+  detector.hasBeat = true;
+  detector.isRrValid = true;
+  detector.lastBeatT = t;
+  detector.lastBeatSampleIndex = sampleIndex;
+  detector.lastBeatEnergy = energy;
+  detector.searchBackValue = 0;
+}
+
+// Classify the peak that has just finished
+static void _classifyPeak(detector_t &detector, const params_t &params) {
+  uint64_t value = detector.peakValue;
+  if (detector.hasBeat && detector.peakT - detector.lastBeatT < params.refractoryLength)
+    return; // Part of the last QRS
+
+  uint64_t threshold = detector.noiseLevel;
+  if (detector.signalLevel > detector.noiseLevel)
+    threshold += (detector.signalLevel - detector.noiseLevel) / 4;
+  if (value > threshold) {
+    // T wave: near the last beat and less than half its slope (a quarter of its energy)
+    if (detector.hasBeat && detector.peakT - detector.lastBeatT < params.tWaveLength &&
+        detector.peakEnergy < detector.lastBeatEnergy / 4) {
+      detector.noiseLevel = (value + 7 * detector.noiseLevel) / 8;
+      return;
+    }
+    detector.signalLevel = (value + 7 * detector.signalLevel) / 8;
+    _addBeat(detector, detector.peakT, detector.peakSampleIndex, detector.peakEnergy, false);
+  } else {
+    detector.noiseLevel = (value + 7 * detector.noiseLevel) / 8;
+    if (value > threshold / 2 && value > detector.searchBackValue) {
+      detector.searchBackValue = value;
+      detector.searchBackEnergy = detector.peakEnergy;
+      detector.searchBackT = detector.peakT;
+      detector.searchBackSampleIndex = detector.peakSampleIndex;
+    }
+  }
+}
+
+void detect(detector_t &detector, const params_t &params, uint64_t energy, uint32_t bandPass, uint32_t sampleIndex) {
+  detector.t++;
+
+  // Moving window integration
+  uint8_t i = detector.integrationIndex;
+  detector.integrationSum += energy - detector.integration[i];
+  detector.integration[i] = energy;
+  detector.integrationIndex = i + 1 < params.integrationLength ? i + 1 : 0;
+  uint64_t integration = detector.integrationSum;
+  uint64_t lastIntegration = detector.lastIntegration;
+  detector.lastIntegration = integration;
+
+  if (detector.settleLeft > 0) {
+    detector.settleLeft--;
+    return;
+  }
+  if (detector.learningLeft > 0) {
+    // The levels start as fractions of the highest peak of the first seconds
+    if (integration > detector.learningMax)
+      detector.learningMax = integration;
+    if (--detector.learningLeft == 0) {
+      detector.signalLevel = detector.learningMax / 3;
+      detector.noiseLevel = detector.learningMax / 16;
+    }
+    return;
+  }
+
+  if (!detector.rising && integration > lastIntegration) {
+    // The integrated signal rises again after the last peak: a new peak starts
+    detector.rising = true;
+    detector.peakValue = 0;
+    detector.bandPassMax = 0;
+    detector.energyMax = 0;
+  }
+  // The R peak is the maximum of the band-pass signal before the peak of the integrated signal
+  if (bandPass >= detector.bandPassMax) {
+    detector.bandPassMax = bandPass;
+    detector.bandPassMaxSampleIndex = sampleIndex - (uint32_t) params.bandPassDelay * params.decimation;
+  }
+  if (energy > detector.energyMax)
+    detector.energyMax = energy;
+
+  if (detector.rising) {
+    if (integration > detector.peakValue) {
+      detector.peakValue = integration;
+      detector.peakT = detector.t;
+      detector.peakSampleIndex = detector.bandPassMaxSampleIndex;
+      detector.peakEnergy = detector.energyMax;
+    } else if (integration < detector.peakValue / 2) {
+      _classifyPeak(detector, params);
+      detector.rising = false;
+    }
+  }
+
+  // Search back: no beat in 166% of the average RR interval
+  if (detector.hasBeat && detector.rrCount > 0 && detector.searchBackValue > 0 &&
+      (detector.t - detector.lastBeatT) * detector.rrCount * 100 > detector.rrSum * 166) {
+    detector.signalLevel = (detector.searchBackValue + 3 * detector.signalLevel) / 4;
+    _addBeat(detector, detector.searchBackT, detector.searchBackSampleIndex, detector.searchBackEnergy, true);
+  }
+}
+
+} // End of the qrs namespace
+} // End of the ads namespace
@@ -0,0 +1,237 @@
+/*
+ * QRS detector (Pan-Tompkins algorithm) that runs on the channels decoded from ADS129x frames, so a board can send the
+ * beats instead of the ECG. It only uses integer arithmetic and the work per sample is constant (no search over the
+ * past samples).
+ *
+ * Every lead (one or more channels) is filtered as in Pan-Tompkins: band-pass (5-15 Hz, two moving sums and the
+ * subtraction of a moving average), derivative and square. The squares of all the leads are added and integrated over
+ * a 150 ms window. The peaks of the integrated signal are classified with two adaptive thresholds (signal and noise
+ * levels), a refractory period of 200 ms, a T wave test (a peak in the 360 ms after a beat with less than half the
+ * slope is a T wave) and a search back with the lower threshold when no beat is found in 166% of the average RR
+ * interval. The beat is placed at the maximum of the band-pass signals.
+ *
+ * The windows depend on the data rate given to begin(). Samples are averaged in blocks to an internal rate between
+ * 250 SPS and 500 SPS (for example, 16 kSPS -> blocks of 64 samples), which is enough for the QRS band and keeps the
+ * buffers small (the detector needs ~800 bytes and ~500 bytes per lead). The first 2 seconds are used to learn the
+ * thresholds, so no beat is given during them.
+ *
+ * Beats have the sample index of the frame with the R peak (see ads_frame_info_t::sampleIndex), with the resolution of
+ * the internal rate. A beat is given ~100 ms after its R peak (or later if it's found by the search back). When there is
+ * a gap in the sample indexes (frames were lost), the filters are cleared but the thresholds are kept.
+ *
+ * Example (lead II in channel 2 of an ADS1298):
+ *    ADS129xQrsDetector<1> detector;
+ *    detector.begin(sensor.getDataRate());
+ *    detector.setLeadChannel(0, 1);
+ *    ...
+ *    ads_frame_span_t span;
+ *    if (sensor.acquireFrames(&span)) {
+ *      detector.processFrames<ads_frame_traits_t>(span.frames, span.nFrames, span.info[0].sampleIndex);
+ *      sensor.releaseFrames(&span);
+ *    }
+ *    ads_beat_t beat;
+ *    while (detector.popBeat(&beat))
+ *      sendBeat(beat.sampleIndex, beat.rrSamples);
+ */
+#ifndef _ADS129X_QRS_DETECTOR_H_
+#define _ADS129X_QRS_DETECTOR_H_
+
+#include "ads129xDecoder.h"
+
+typedef struct {
+  uint32_t sampleIndex; // Sample index of the R peak
+  uint32_t rrSamples; // Samples since the previous beat. 0 for the first beat and the first one after a gap
+  boolean searchBack; // Found by the search back (the peak was below the signal threshold)
+} ads_beat_t;
+
+namespace ads {
+namespace qrs {
+
+const uint16_t MIN_DATA_RATE = 100;
+// The fastest data rate of ADS (HR mode, DR = 000). The internal rate stays in [250, 500) SPS with a decimation < 256
+const uint16_t MAX_DATA_RATE = 32000;
+const uint8_t BEAT_BUFFER_SIZE = 4; // Power of 2
+const uint8_t _BEAT_BUFFER_MASK = BEAT_BUFFER_SIZE - 1;
+const uint8_t _RR_INTERVALS = 8; // RR intervals of the average
+// Sizes of the buffers for the highest internal rate (< 500 SPS)
+const uint8_t _MAX_LOW_PASS = 15; // 30 ms
+const uint8_t _MAX_HIGH_PASS = 81; // 160 ms
+const uint8_t _MAX_DERIVATIVE = 9; // 4 steps of up to 2 samples
+const uint8_t _MAX_INTEGRATION = 75; // 150 ms
+
+// Parameters computed from the data rate. The lengths are in internal samples
+struct params_t {
+  uint8_t decimation; // Input samples per internal sample
+  uint16_t rate; // Internal rate
+  uint8_t lowPassLength, lowPassShift;
+  uint8_t highPassLength, highPassShift;
+  uint8_t derivativeStep;
+  uint8_t integrationLength;
+  uint16_t bandPassDelay; // Delay of the band-pass filter
+  uint16_t settleLength; // Samples until the integrated signal is valid after a reset
+  uint16_t refractoryLength, tWaveLength, learningLength;
+};
+
+// Filters of a lead
+struct lead_t {
+  int32_t blockSum;
+  int32_t lowPass1[_MAX_LOW_PASS], lowPass2[_MAX_LOW_PASS], highPass[_MAX_HIGH_PASS], derivative[_MAX_DERIVATIVE];
+  int32_t lowPass1Sum, lowPass2Sum;
+  int64_t highPassSum;
+  uint8_t lowPassIndex, highPassIndex, derivativeIndex;
+};
+
+// Detection over the integrated signal of all the leads
+struct detector_t {
+  uint64_t integration[_MAX_INTEGRATION];
+  uint64_t integrationSum, lastIntegration;
+  uint8_t integrationIndex;
+  uint32_t t; // Internal samples since begin()
+  uint16_t settleLeft, learningLeft;
+  uint64_t learningMax;
+  uint64_t signalLevel, noiseLevel; // SPKI and NPKI of Pan-Tompkins
+
+  // Peak that is being tracked
+  boolean rising;
+  uint64_t peakValue, peakEnergy, energyMax;
+  uint32_t peakT, peakSampleIndex, bandPassMax, bandPassMaxSampleIndex;
+
+  // Best peak between both thresholds since the last beat (search back)
+  uint64_t searchBackValue, searchBackEnergy;
+  uint32_t searchBackT, searchBackSampleIndex;
+
+  boolean hasBeat, isRrValid;
+  uint32_t lastBeatT, lastBeatSampleIndex;
+  uint64_t lastBeatEnergy;
+  uint16_t rr[_RR_INTERVALS];
+  uint32_t rrSum;
+  uint8_t rrCount, rrIndex;
+
+  ads_beat_t beats[BEAT_BUFFER_SIZE];
+  uint8_t beatHead, beatTail;
+};
+
+// Compute the parameters for dataRate samples per second. Return false if dataRate < MIN_DATA_RATE or dataRate > MAX_DATA_RATE
+boolean setParams(params_t &params, uint16_t dataRate);
+void resetLead(lead_t &lead);
+// Filter an internal sample (the average of a block of input samples) of a lead. bandPass is the band-pass signal and
+// the result is the square of the derivative
+uint64_t filterLead(lead_t &lead, const params_t &params, int32_t x, int32_t &bandPass);
+// Clear everything (learnThresholds = true, after begin()) or only the signals (after a gap in the samples)
+void resetDetector(detector_t &detector, const params_t &params, boolean learnThresholds);
+// Process an internal sample. energy and bandPass are added over the leads. sampleIndex is the sample index of the
+// middle of the block of input samples
+void detect(detector_t &detector, const params_t &params, uint64_t energy, uint32_t bandPass, uint32_t sampleIndex);
+
+} // End of the qrs namespace
+} // End of the ads namespace
+
+/* ======= ADS129xQrsDetector class definition  ============= */
+// QRS detector over nLeads leads. Lead l is the channel setLeadChannel(l, channel) (channel l by default)
+template <uint8_t nLeads = 1>
+class ADS129xQrsDetector {
+  private:
+    ads::qrs::params_t params;
+    ads::qrs::lead_t leads[nLeads];
+    ads::qrs::detector_t detector;
+    uint8_t leadChannels[nLeads];
+    uint8_t blockCount; // Input samples in the current block
+    uint32_t blockFirstSampleIndex;
+    uint32_t nextSampleIndex;
+    boolean isFirstSample;
+    static const uint8_t _TILE_FRAMES = 8; // Frames decoded at once by processFrames()
+
+    void resetSignals(boolean learnThresholds) {
+      for (uint8_t l = 0; l < nLeads; l++)
+        ads::qrs::resetLead(leads[l]);
+      ads::qrs::resetDetector(detector, params, learnThresholds);
+      blockCount = 0;
+    }
+
+  public:
+    ADS129xQrsDetector() {
+      for (uint8_t l = 0; l < nLeads; l++)
+        leadChannels[l] = l;
+      begin(250);
+    }
+
+    // Set the data rate of the samples (see ADS129xSensor::getDataRate()) and start to learn the thresholds. Return
+    // false if dataRate < ads::qrs::MIN_DATA_RATE or dataRate > ads::qrs::MAX_DATA_RATE
+    boolean begin(uint16_t dataRate) {
+      if (!ads::qrs::setParams(params, dataRate))
+        return false;
+      resetSignals(true);
+      isFirstSample = true;
+      return true;
+    }
+    // Channel of a lead (index of the channel in the decoded frames)
+    void setLeadChannel(uint8_t lead, uint8_t channel) {
+      if (lead < nLeads)
+        leadChannels[lead] = channel;
+    }
+
+    // Process one decoded frame (samples[c] is channel c, see decodeFrames()) with its sample index
+    void process(uint32_t sampleIndex, const int32_t *samples) {
+      if (sampleIndex != nextSampleIndex && !isFirstSample)
+        resetSignals(false); // Gap: the filters would mix unrelated samples
+      nextSampleIndex = sampleIndex + 1;
+      isFirstSample = false;
+
+      if (blockCount == 0)
+        blockFirstSampleIndex = sampleIndex;
+      for (uint8_t l = 0; l < nLeads; l++)
+        leads[l].blockSum += samples[leadChannels[l]];
+      if (++blockCount < params.decimation)
+        return;
+
+      uint64_t energy = 0;
+      uint32_t bandPass = 0;
+      for (uint8_t l = 0; l < nLeads; l++) {
+        int32_t x = leads[l].blockSum / params.decimation;
+        leads[l].blockSum = 0;
+        int32_t leadBandPass;
+        energy += ads::qrs::filterLead(leads[l], params, x, leadBandPass);
+        bandPass += leadBandPass < 0 ? -leadBandPass : leadBandPass;
+      }
+      blockCount = 0;
+      ads::qrs::detect(detector, params, energy, bandPass, blockFirstSampleIndex + (params.decimation - 1) / 2);
+    }
+    // Process nFrames decoded frames with the frame by frame layout: samples[f * nChannels + c] (see decodeFrames()).
+    // Their sample indexes are firstSampleIndex, firstSampleIndex + 1, ...
+    void processInterleaved(const int32_t *samples, uint32_t nFrames, uint8_t nChannels, uint32_t firstSampleIndex) {
+      for (uint32_t f = 0; f < nFrames; f++)
+        process(firstSampleIndex + f, samples + f * nChannels);
+    }
+    // Decode and process nFrames frames (for example, the frames of a span of the ring buffer)
+    template <class Frame>
+    void processFrames(const typename Frame::data_t *frames, uint32_t nFrames, uint32_t firstSampleIndex) {
+      int32_t tile[_TILE_FRAMES * Frame::TOTAL_CHANNELS];
+      for (uint32_t f = 0; f < nFrames; f += _TILE_FRAMES) {
+        uint32_t n = nFrames - f < _TILE_FRAMES ? nFrames - f : _TILE_FRAMES;
+        ads::decoder::decodeFrames<Frame>(frames + f, n, tile);
+        processInterleaved(tile, n, Frame::TOTAL_CHANNELS, firstSampleIndex + f);
+      }
+    }
+
+    // Number of beats that haven't been read
+    uint8_t availableBeats() {
+      return (detector.beatHead - detector.beatTail) & ads::qrs::_BEAT_BUFFER_MASK;
+    }
+    // Get the oldest beat that hasn't been read. Return false if there isn't any. If the beats aren't read, only the
+    // first BEAT_BUFFER_SIZE - 1 beats are kept
+    boolean popBeat(ads_beat_t *beat) {
+      if (detector.beatHead == detector.beatTail)
+        return false;
+      *beat = detector.beats[detector.beatTail];
+      detector.beatTail = (detector.beatTail + 1) & ads::qrs::_BEAT_BUFFER_MASK;
+      return true;
+    }
+    // Heart rate in beats per minute from the average of the last RR intervals. 0 if there isn't any RR interval yet
+    uint16_t getHeartRate() {
+      if (detector.rrCount == 0)
+        return 0;
+      return (uint32_t) 60 * params.rate * detector.rrCount / detector.rrSum;
+    }
+};
+
+#endif /* _ADS129X_QRS_DETECTOR_H_ */
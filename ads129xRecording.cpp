@@ -0,0 +1,206 @@
+#include "ads129xRecording.h"
+
+#include <string.h>
+
+namespace ads {
+namespace recording {
+
+// Reflected polynomial 0xEDB88320, 4 bits per step (a table of 16 values instead of 256 for the small boards)
+uint32_t crc32(const void *data, uint32_t nBytes, uint32_t crc) {
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  const byte *bytes = (const byte *) data;
+  crc = ~crc;
+  for (uint32_t i = 0; i < nBytes; i++) {
+    crc = table[(crc ^ bytes[i]) & 0x0F] ^ (crc >> 4);
+    crc = table[(crc ^ (bytes[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+} // End of the recording namespace
+} // End of the ads namespace
+
+
+/* ======= ADS129xRecordingWriter ============= */
+template <uint8_t chip, uint8_t bits>
+ADS129xChipRecordingWriter<chip, bits>::ADS129xChipRecordingWriter(data_t *chunkFrames, uint16_t framesPerChunk,
+                                                                  ads_recording_output_t output, void *outputContext) {
+  this->chunkFrames = chunkFrames;
+  this->framesPerChunk = framesPerChunk;
+  this->output = output;
+  this->outputContext = outputContext;
+  nChunks = 0;
+  memset(&chunk, 0, sizeof(chunk));
+#if ADS_RUNTIME_FRAME_WIDTH
+  bitsPerChannel = 0;
+#endif
+}
+
+template <uint8_t chip, uint8_t bits>
+boolean ADS129xChipRecordingWriter<chip, bits>::begin(sensor_t &sensor) {
+  byte registers[ads::registers::N_REGISTERS];
+  for (uint8_t i = 0; i < ads::registers::N_REGISTERS; i++)
+    registers[i] = sensor.getRegisterShadow(i);
+  return begin(registers);
+}
+
+template <uint8_t chip, uint8_t bits>
+boolean ADS129xChipRecordingWriter<chip, bits>::begin(const byte *registers) {
+  using namespace ads::registers;
+
+  ads_recording_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = ads::recording::HEADER_MAGIC;
+  header.version = ads::recording::VERSION;
+  header.headerSize = sizeof(ads_recording_header_t);
+  header.chipId = registers[id::REG_ADDR];
+#if ADS_RUNTIME_FRAME_WIDTH
+  // 16 bits frames are stored in data_t slots (frameSize is the slot size), like in the ring buffer
+  header.bitsPerChannel = config1::bitsPerChannel(registers[config1::REG_ADDR]);
+  bitsPerChannel = header.bitsPerChannel;
+#else
+  header.bitsPerChannel = bits;
+#endif
+  header.nDevices = ADS_DAISY_CHAIN_DEVICES;
+  header.nChannels = sensor_t::N_CHANNELS;
+  header.dataRate = config1::dataRate(registers[config1::REG_ADDR]);
+  header.frameSize = sizeof(data_t);
+  header.framesPerChunk = framesPerChunk;
+  header.chunkSize = ads::recording::chunkSize(framesPerChunk, sizeof(data_t));
+  memcpy(header.registers, registers, N_REGISTERS);
+  for (uint8_t i = 0; i < sensor_t::N_CHANNELS; i++)
+    header.channelGain[i] = chnSet::gain(registers[chnSet::_BASE_REG_ADDR + 1 + i]);
+  header.crc = ads::recording::crc32(&header, offsetof(ads_recording_header_t, crc));
+
+  nChunks = 0;
+  chunk.nFrames = 0;
+  return output(outputContext, &header, sizeof(header));
+}
+
+template <uint8_t chip, uint8_t bits>
+boolean ADS129xChipRecordingWriter<chip, bits>::writeFrame(const data_t *frame, const ads_frame_info_t *info) {
+#if ADS_RUNTIME_FRAME_WIDTH
+  // The frame size of the recording is fixed by the header
+  if (info->bitsPerChannel != bitsPerChannel)
+    return false;
+#endif
+
+  // Frames of a chunk must be consecutive samples
+  if (chunk.nFrames > 0 && info->sampleIndex != chunk.firstSampleIndex + chunk.nFrames) {
+    if (!flush())
+      return false;
+  }
+
+  if (chunk.nFrames == 0) {
+    chunk.firstSampleIndex = info->sampleIndex;
+    chunk.firstTimestampUs = info->timestampUs;
+  }
+  chunkFrames[chunk.nFrames] = *frame;
+  chunk.nFrames++;
+
+  if (chunk.nFrames == framesPerChunk)
+    return flush();
+  return true;
+}
+
+template <uint8_t chip, uint8_t bits>
+boolean ADS129xChipRecordingWriter<chip, bits>::flush() {
+  if (chunk.nFrames == 0)
+    return true; // Nothing to write
+
+  uint32_t framesBytes = (uint32_t) chunk.nFrames * sizeof(data_t);
+  chunk.magic = ads::recording::CHUNK_MAGIC;
+  chunk.reserved = 0;
+  chunk.crc = ads::recording::crc32(&chunk, offsetof(ads_recording_chunk_t, crc));
+  chunk.crc = ads::recording::crc32(chunkFrames, framesBytes, chunk.crc);
+
+  // Every chunk has the same size -> the frames that weren't received and the alignment padding are filled with zeros
+  static const byte zeros[16] = {0};
+  uint32_t paddingBytes = ads::recording::chunkSize(framesPerChunk, sizeof(data_t)) - sizeof(ads_recording_chunk_t) - framesBytes;
+  boolean ok = output(outputContext, &chunk, sizeof(chunk)) && output(outputContext, chunkFrames, framesBytes);
+  while (ok && paddingBytes > 0) {
+    uint32_t nBytes = paddingBytes < sizeof(zeros) ? paddingBytes : sizeof(zeros);
+    ok = output(outputContext, zeros, nBytes);
+    paddingBytes -= nBytes;
+  }
+
+  chunk.nFrames = 0;
+  if (ok)
+    nChunks++;
+  return ok;
+}
+
+// Like the sensors (see the end of ads129xDriver.cpp), the writers of all chip models are compiled here
+#define _ADS_RECORDING_WRITERS_WITH_BITS(bits) \
+  template class ADS129xChipRecordingWriter<ADS_1294, bits>; \
+  template class ADS129xChipRecordingWriter<ADS_1294R, bits>; \
+  template class ADS129xChipRecordingWriter<ADS_1296, bits>; \
+  template class ADS129xChipRecordingWriter<ADS_1296R, bits>; \
+  template class ADS129xChipRecordingWriter<ADS_1298, bits>; \
+  template class ADS129xChipRecordingWriter<ADS_1298R, bits>;
+
+_ADS_RECORDING_WRITERS_WITH_BITS(24)
+#if !ADS_RUNTIME_FRAME_WIDTH
+_ADS_RECORDING_WRITERS_WITH_BITS(16)
+#endif
+
+
+/* ======= ADS129xRecordingReader ============= */
+boolean ADS129xRecordingReader::open(const void *data, uint64_t size) {
+  this->data = NULL;
+  this->size = 0;
+
+  const ads_recording_header_t *header = (const ads_recording_header_t *) data;
+  if (data == NULL || size < sizeof(ads_recording_header_t) || header->magic != ads::recording::HEADER_MAGIC)
+    return false;
+  // Newer versions can add fields at the end of the header (headerSize) but they can't change the fields of version 1
+  if (header->version < 1 || header->headerSize < sizeof(ads_recording_header_t) || header->headerSize > size)
+    return false;
+  if (header->crc != ads::recording::crc32(header, offsetof(ads_recording_header_t, crc)))
+    return false;
+  // In 64 bits: chunkSize() wraps around with a big framesPerChunk and the frames would be read beyond the chunk
+  if (header->framesPerChunk == 0 ||
+      header->chunkSize < sizeof(ads_recording_chunk_t) + (uint64_t) header->framesPerChunk * header->frameSize)
+    return false;
+
+  this->data = (const byte *) data;
+  this->size = size;
+  return true;
+}
+
+boolean ADS129xRecordingReader::areFramesInChunk(const ads_recording_chunk_t *chunk) {
+  return sizeof(ads_recording_chunk_t) + (uint64_t) chunk->nFrames * getHeader()->frameSize <= getHeader()->chunkSize;
+}
+
+uint32_t ADS129xRecordingReader::getChunkCount() {
+  if (data == NULL)
+    return 0;
+  // The last chunk is ignored if it is incomplete (the recording was cut)
+  return (size - getHeader()->headerSize) / getHeader()->chunkSize;
+}
+
+const ads_recording_chunk_t * ADS129xRecordingReader::getChunk(uint32_t index) {
+  if (index >= getChunkCount())
+    return NULL;
+  return (const ads_recording_chunk_t *) (data + getHeader()->headerSize + (uint64_t) index * getHeader()->chunkSize);
+}
+
+boolean ADS129xRecordingReader::isChunkValid(uint32_t index) {
+  const ads_recording_chunk_t *chunk = getChunk(index);
+  if (chunk == NULL || chunk->magic != ads::recording::CHUNK_MAGIC || chunk->nFrames > getHeader()->framesPerChunk ||
+      !areFramesInChunk(chunk))
+    return false;
+  uint32_t crc = ads::recording::crc32(chunk, offsetof(ads_recording_chunk_t, crc));
+  crc = ads::recording::crc32(chunk + 1, (uint32_t) chunk->nFrames * getHeader()->frameSize, crc);
+  return crc == chunk->crc;
+}
+
+const byte * ADS129xRecordingReader::getRawFrames(uint32_t index) {
+  const ads_recording_chunk_t *chunk = getChunk(index);
+  if (chunk == NULL || !areFramesInChunk(chunk))
+    return NULL;
+  return (const byte *) (chunk + 1);
+}
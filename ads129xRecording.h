@@ -0,0 +1,194 @@
+/*
+ * Binary recording format of the frames sent by ADS129x chips, with a writer that streams it to any output (a file in a
+ * computer, a SD card in a board, ...) and a reader that works in place over the whole recording in memory (for example,
+ * a file mapped with mmap, see extras/recording/ads129xRecordingFile.h).
+ *
+ * Layout (all the numbers are little-endian, the byte order of AVR, ARM and x86):
+ *
+ *    +-------------------------------+  0
+ *    | ads_recording_header_t        |  header.headerSize bytes (128 in version 1)
+ *    +-------------------------------+  headerSize
+ *    | chunk 0                       |  header.chunkSize bytes
+ *    +-------------------------------+  headerSize + chunkSize
+ *    | chunk 1                       |
+ *    | ...                           |
+ *
+ *    chunk: ads_recording_chunk_t (20 bytes) + header.framesPerChunk frames of header.frameSize bytes + padding
+ *
+ * The header describes the chip (ID, bits per channel, data rate, number of devices in daisy-chain), has a copy of the
+ * register map when the recording started and the gain of every channel. Frames are stored as ADS sends them (data_t of
+ * the sensor, ads_data_t for ADS129xSensor), so a chunk can be used as an array of frames without any copy (for example,
+ * with ads::decoder::decodeFrames()). With ADS_RUNTIME_FRAME_WIDTH, 16 bits frames are stored in 24 bits slots (read them
+ * with ads_frame16_traits_t for ADS129xSensor), so start a new recording when the data rate changes.
+ *
+ * Every chunk has the same size, so chunk i is at headerSize + i * chunkSize: any chunk is found in O(1) and the number
+ * of chunks is known from the file size. The frames of a chunk are consecutive samples: the sample index of frame j is
+ * firstSampleIndex + j. When a frame is lost (a gap in ads_frame_info_t::sampleIndex), the chunk is closed before it is
+ * full (nFrames < framesPerChunk) and a new chunk starts. The writer only needs memory for one chunk and it only appends
+ * data, so a recording can be as long as the storage lets. If the recording is cut (power loss, ...), only the last
+ * incomplete chunk is lost.
+ *
+ * The header and every chunk have a CRC-32 (the one used by zip, Ethernet, ...).
+ */
+#ifndef _ADS129X_RECORDING_H_
+#define _ADS129X_RECORDING_H_
+
+#include "ads129xDriver.h"
+
+namespace ads {
+namespace recording {
+
+const uint32_t HEADER_MAGIC = 0x52534441; // "ADSR"
+const uint32_t CHUNK_MAGIC = 0x43534441; // "ADSC"
+const uint16_t VERSION = 1;
+const uint8_t MAX_CHANNELS_PER_DEVICE = 8;
+
+// CRC-32 of nBytes bytes. Pass the CRC of the previous bytes in crc to compute the CRC of several buffers
+uint32_t crc32(const void *data, uint32_t nBytes, uint32_t crc = 0);
+
+} // End of the recording namespace
+} // End of the ads namespace
+
+typedef struct {
+  uint32_t magic; // ads::recording::HEADER_MAGIC
+  uint16_t version; // ads::recording::VERSION
+  uint16_t headerSize; // Bytes before the first chunk
+  byte chipId; // ID register
+  uint8_t bitsPerChannel;
+  uint8_t nDevices; // Devices in daisy-chain (1 if there isn't daisy-chain)
+  uint8_t nChannels; // Channels of every device
+  uint16_t dataRate; // Samples per second (from CONFIG1)
+  uint16_t frameSize; // Bytes of one frame (the data of all the devices)
+  uint32_t framesPerChunk;
+  uint32_t chunkSize; // Bytes of one chunk, header of the chunk included
+  byte registers[ads::registers::N_REGISTERS]; // Register map when the recording started
+  uint8_t channelGain[ads::recording::MAX_CHANNELS_PER_DEVICE]; // PGA gain of every channel (from CHnSET)
+  byte reserved[128 - 36 - ads::registers::N_REGISTERS]; // 0 (36 = bytes of the other fields, crc included)
+  uint32_t crc; // CRC-32 of the previous bytes of the header
+} ads_recording_header_t;
+static_assert(sizeof(ads_recording_header_t) == 128, "The header of the recordings must have 128 bytes");
+
+typedef struct {
+  uint32_t magic; // ads::recording::CHUNK_MAGIC
+  uint32_t firstSampleIndex; // Sample index of the first frame (see ads_frame_info_t)
+  uint32_t firstTimestampUs; // Timestamp of the first frame (see ads_frame_info_t)
+  uint16_t nFrames; // Frames stored in the chunk. Less than framesPerChunk if the chunk was closed before it was full
+  uint16_t reserved; // 0
+  uint32_t crc; // CRC-32 of the previous bytes of the chunk header and the nFrames frames
+} ads_recording_chunk_t;
+static_assert(sizeof(ads_recording_chunk_t) == 20, "The header of the chunks must have 20 bytes");
+
+namespace ads {
+namespace recording {
+
+// Bytes of a chunk with framesPerChunk frames of frameSize bytes. It's a multiple of 4, so the headers of the chunks are
+// aligned when the recording is mapped in memory
+inline uint32_t chunkSize(uint32_t framesPerChunk, uint16_t frameSize = _ADS_DATA_PACKAGE_SIZE) {
+  return (sizeof(ads_recording_chunk_t) + framesPerChunk * frameSize + 3) & ~(uint32_t) 3;
+}
+
+} // End of the recording namespace
+} // End of the ads namespace
+
+// Write nBytes bytes in the output (context is the pointer given to ADS129xRecordingWriter). Return false if it fails
+typedef boolean (*ads_recording_output_t)(void *context, const void *data, uint32_t nBytes);
+
+/* ======= ADS129xRecordingWriter class definition  ============= */
+// Write a recording of the frames of an ADS129xChipSensor<chip, bits>. ADS129xRecordingWriter (defined below the class)
+// is the one of ADS129xSensor (the chip model set in ads129xDriverConfig.h). Example (SD card in a board):
+//
+//    ads_data_t chunkFrames[16];
+//    ADS129xRecordingWriter writer(chunkFrames, 16, writeInSdCard, &file);
+//    writer.begin(sensor);
+//    ...
+//    while (sensor.available()) {
+//      writer.writeFrame(sensor.peek(), sensor.peekInfo());
+//      sensor.pop();
+//    }
+//    ...
+//    writer.flush();
+template <uint8_t chip, uint8_t bits = ADS_BITS_PER_CHANNEL>
+class ADS129xChipRecordingWriter {
+  public:
+    typedef ADS129xChipSensor<chip, bits> sensor_t;
+    typedef typename sensor_t::data_t data_t;
+
+  private:
+    ads_recording_chunk_t chunk; // Header of the chunk that is being filled
+    data_t *chunkFrames; // Frames of the chunk that is being filled
+    uint16_t framesPerChunk;
+    ads_recording_output_t output;
+    void *outputContext;
+    uint32_t nChunks; // Chunks written
+#if ADS_RUNTIME_FRAME_WIDTH
+    uint8_t bitsPerChannel; // bitsPerChannel of the header. The frames with other width don't belong to the recording
+#endif
+
+  public:
+    // chunkFrames must have room for framesPerChunk frames. It's used until the writer is destroyed
+    ADS129xChipRecordingWriter(data_t *chunkFrames, uint16_t framesPerChunk, ads_recording_output_t output, void *outputContext);
+
+    // Write the header of the recording. The registers are taken from the register shadow of the sensor (no SPI
+    // communication is done, so it can be called in RDATAC mode)
+    boolean begin(sensor_t &sensor);
+    // The same but with a copy of the register map (ads::registers::N_REGISTERS registers, see readAllRegisters())
+    boolean begin(const byte *registers);
+    // Add a frame to the recording. The chunk is written when it's full or when the frame isn't the next sample of the
+    // chunk (a frame was lost). With ADS_RUNTIME_FRAME_WIDTH, a frame whose info->bitsPerChannel isn't the one of the
+    // header (the data rate changed after begin()) isn't added and false is returned: start a new recording
+    boolean writeFrame(const data_t *frame, const ads_frame_info_t *info);
+    // Write the chunk that is being filled, although it isn't full. Call it before closing the output
+    boolean flush();
+    // Number of chunks written in the output
+    uint32_t getChunkCount() {
+      return nChunks;
+    }
+};
+
+typedef ADS129xChipRecordingWriter<ADS_CHIP_USED, ADS_BITS_PER_CHANNEL> ADS129xRecordingWriter;
+
+/* ======= ADS129xRecordingReader class definition  ============= */
+// Read a recording that is in memory. No data is copied: the methods return pointers to the recording.
+class ADS129xRecordingReader {
+  private:
+    const byte *data;
+    uint64_t size;
+
+    // The nFrames frames of the chunk don't go beyond its chunkSize bytes (a corrupted chunk can have any nFrames)
+    boolean areFramesInChunk(const ads_recording_chunk_t *chunk);
+
+  public:
+    ADS129xRecordingReader() {
+      data = NULL;
+      size = 0;
+    }
+
+    // Check the header of the recording (size bytes starting at data). Return false if it isn't a valid recording
+    boolean open(const void *data, uint64_t size);
+
+    const ads_recording_header_t * getHeader() {
+      return (const ads_recording_header_t *) data;
+    }
+    // Number of complete chunks
+    uint32_t getChunkCount();
+    // Header of the chunk index. NULL if index >= getChunkCount()
+    const ads_recording_chunk_t * getChunk(uint32_t index);
+    // Check the CRC of the chunk
+    boolean isChunkValid(uint32_t index);
+    // Frames of the chunk index (getChunk(index)->nFrames frames of getHeader()->frameSize bytes). NULL if index >= getChunkCount()
+    // or the frames don't fit in the chunk
+    const byte * getRawFrames(uint32_t index);
+    // Frames of the chunk index as an array of Frame::data_t (Frame is an ads::frame_traits). NULL if index >= getChunkCount()
+    // or the frames of the recording aren't Frame frames. Example:
+    //    ads::decoder::decodeFrames<Frame>(reader.getFrames<Frame>(i), reader.getChunk(i)->nFrames, out);
+    template <class Frame>
+    const typename Frame::data_t * getFrames(uint32_t index) {
+      const ads_recording_header_t *header = getHeader();
+      if (header == NULL || header->chipId != ads::chip_traits<Frame::CHIP>::ID || header->bitsPerChannel != Frame::BITS_PER_CHANNEL ||
+          header->nDevices != Frame::N_DEVICES || header->frameSize != sizeof(typename Frame::data_t))
+        return NULL;
+      return (const typename Frame::data_t *) getRawFrames(index);
+    }
+};
+
+#endif /* _ADS129X_RECORDING_H_ */
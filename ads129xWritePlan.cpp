@@ -0,0 +1,80 @@
+#include "ads129xDriver.h"
+
+namespace ads {
+namespace plan {
+
+using namespace ads::registers;
+
+static const uint32_t _READ_ONLY_REGISTERS =
+  ((uint32_t) 1 << id::REG_ADDR) | ((uint32_t) 1 << loffStatp::REG_ADDR) | ((uint32_t) 1 << loffStatn::REG_ADDR);
+static const uint32_t _INTERNAL_RESET_REGISTERS = ((uint32_t) 1 << config1::REG_ADDR) | ((uint32_t) 1 << resp::REG_ADDR);
+// Registers that can't be written with their current value to join two bursts
+static const uint32_t _NOT_FILLER_REGISTERS = _READ_ONLY_REGISTERS | _INTERNAL_RESET_REGISTERS | ((uint32_t) 1 << gpio::REG_ADDR);
+
+static boolean _isSet(uint32_t registers, uint8_t addr) {
+  return (registers & ((uint32_t) 1 << addr)) != 0;
+}
+
+uint32_t diff(const byte *current, const byte *target) {
+  uint32_t changedRegisters = 0;
+  for (uint8_t addr = 0; addr < N_REGISTERS; addr++) {
+    if (current[addr] != target[addr])
+      changedRegisters |= (uint32_t) 1 << addr;
+  }
+  return changedRegisters & ~_READ_ONLY_REGISTERS;
+}
+
+void make(uint32_t changedRegisters, plan_t &plan) {
+  changedRegisters &= ~_READ_ONLY_REGISTERS;
+
+  // Bursts in address order. A burst goes on while the next register changes or only one clean register (that can be
+  // written again) is before the next changed one: 1 byte instead of the 2 bytes of a new burst
+  burst_t bursts[MAX_BURSTS];
+  uint8_t nBursts = 0;
+  uint8_t addr = 0;
+  while (addr < N_REGISTERS) {
+    if (!_isSet(changedRegisters, addr)) {
+      addr++;
+      continue;
+    }
+    uint8_t end = addr + 1;
+    while (end < N_REGISTERS) {
+      if (_isSet(changedRegisters, end))
+        end++;
+      else if (end + 1 < N_REGISTERS && _isSet(changedRegisters, end + 1) && !_isSet(_NOT_FILLER_REGISTERS, end))
+        end += 2;
+      else
+        break;
+    }
+    bursts[nBursts].startAddr = addr;
+    bursts[nBursts].count = end - addr;
+    nBursts++;
+    addr = end;
+  }
+
+  // The bursts with an internal reset go last (in address order too)
+  plan.nBursts = 0;
+  plan.nBytes = 0;
+  plan.nInternalResets = 0;
+  for (uint8_t pass = 0; pass < 2; pass++) {
+    for (uint8_t b = 0; b < nBursts; b++) {
+      uint32_t burstRegisters = (((uint32_t) 1 << bursts[b].count) - 1) << bursts[b].startAddr;
+      boolean hasInternalReset = (burstRegisters & _INTERNAL_RESET_REGISTERS) != 0;
+      if (hasInternalReset != (pass == 1))
+        continue;
+      plan.bursts[plan.nBursts++] = bursts[b];
+      plan.nBytes += 2 + bursts[b].count;
+      if (hasInternalReset)
+        plan.nInternalResets++;
+    }
+  }
+}
+
+uint32_t estimateUs(const plan_t &plan, uint32_t spiClockHz) {
+  // Rounded up: it's used to know if the reconfiguration fits in a time
+  uint32_t spiUs = ((uint32_t) plan.nBytes * 8 * 1000000 + spiClockHz - 1) / spiClockHz;
+  return spiUs + plan.nInternalResets * (uint32_t) _ADS_T_CLK_18;
+}
+
+} // End of the plan namespace
+} // End of the ads namespace
@@ -0,0 +1,52 @@
+/*
+ * Plan of the WREG commands (bursts) that write the registers that change. It's used by ADS129xSensor::flushRegisters()
+ * (and so by the helper methods, endRegisterChanges() and the profiles of ads129xProfile.h), but it can also be used
+ * alone to know what a reconfiguration costs before doing it (for example, in the middle of a recording). It's included
+ * by ads129xDriver.h (include that one).
+ *
+ * A burst costs 2 bytes (WREG command and number of registers) plus 1 byte per register. So:
+ *   - One clean register between two changed ones is written again with its current value (1 byte instead of the 2 bytes
+ *     of a new burst) when writing it has no side effect: it isn't read-only, CONFIG1 or RESP (internal reset, see below)
+ *     or GPIO (its data bits can be changed by ADS).
+ *   - Writing CONFIG1 or RESP resets the digital filter of ADS: the conversions restart and no command can be sent during
+ *     18 t_CLK (see page 48, section 9.3.2.3 Reset (RESET Pin and Reset Command), in the datasheet). The bursts with
+ *     these registers are the last ones, so every register is written once and the conversions restart only after the
+ *     whole configuration is written.
+ */
+#ifndef _ADS129X_WRITE_PLAN_H_
+#define _ADS129X_WRITE_PLAN_H_
+
+#include "ads129xDatasheetConstants.h"
+
+namespace ads {
+namespace plan {
+
+// Every burst has at least one changed register and two bursts have at least one register between them
+const uint8_t MAX_BURSTS = (ads::registers::N_REGISTERS + 1) / 2;
+
+// count registers written with one WREG command, starting at startAddr
+struct burst_t {
+  uint8_t startAddr;
+  uint8_t count;
+};
+
+struct plan_t {
+  burst_t bursts[MAX_BURSTS]; // In the order they must be written
+  uint8_t nBursts;
+  uint8_t nBytes; // SPI bytes of all the bursts
+  uint8_t nInternalResets; // Bursts that write CONFIG1 or RESP (they are the last ones)
+};
+
+// Registers (bit i is 1 -> register with address i) that are different in current and target. Read-only registers are
+// ignored
+uint32_t diff(const byte *current, const byte *target);
+// Plan the bursts that write the changedRegisters (bit i is 1 -> register with address i). Read-only registers are ignored
+void make(uint32_t changedRegisters, plan_t &plan);
+// Expected time of the plan in microseconds: SPI bytes at spiClockHz plus the wait after every internal reset. The default
+// clock is the one used by the driver for the registers
+uint32_t estimateUs(const plan_t &plan, uint32_t spiClockHz = _ADS_SPI_MAX_SPEED);
+
+} // End of the plan namespace
+} // End of the ads namespace
+
+#endif /* _ADS129X_WRITE_PLAN_H_ */
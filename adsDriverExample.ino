@@ -1,6 +1,7 @@
 #include <Arduino.h>
 
 #include "ads129xDriver.h"
+#include "ads129xDecoder.h"
 
 
 // The driver is configured to take control of an ADS1294 chip.
@@ -128,21 +129,12 @@ void loop() {
     Serial.print("\t");
 
     // Transform sample to voltage
-    // Remember that is in MSB (most significant bit) order!!! Position 0
-    // ADS send samples in 24 bits and in binary twos complement format.
-    byte *byteSample = (byte*) &adsData->formatedData.channel[0];
-    // For an easy manipulation, transform twos complement format to binary offset. It is equivalent to an unsigned value
-    // with V_Ref offset. The new zero is equivalent in the real world to maximum negative value possible
-    byte mask = byteSample[0] & 0x80;
-    mask ^= 0x80;
-    byte offsetBinary = mask | (byteSample[0] & 0x7F);
-    // Sample in binary offset of 24 bits. Remember, it has in MSB format. We can access with adsData->formatedData.channel[0].{hi,mid,low} fields
-    int32_t sampleValue = (offsetBinary << 16) + (byteSample[1] << 8) + byteSample[2];
-    // Remove offset and scale the variable before printing in the monitor
+    // Remember that is in MSB (most significant bit) order and in binary twos complement format.
+    // ads::decoder::decodeFrames() (see ads129xDecoder.h) converts many frames at once
+    int32_t sampleValue = ads::decoder::decodeSample(adsData->formatedData.channel[0]);
     float v_ref = 2.4; // V_ref for the ADS1294. In my setup, VREFP = 2.4V (see VREF_4V bit in config3) and VREFN = 0V (connected to ground)
-    float channelGain = 1;
-    float sampleInVoltsAndWithOffset = v_ref * ((float) sampleValue) / (pow(2, 23) - 1) / channelGain;
-    float sampleInVolts = sampleInVoltsAndWithOffset - v_ref;
+    uint8_t channelGain = 1;
+    float sampleInVolts = sampleValue * ads::decoder::lsbVolts(v_ref, channelGain);
     Serial.print("Equivalent value in milivolts");
     Serial.print("\t");
     Serial.println(sampleInVolts * 1e3, 5);
@@ -154,8 +146,8 @@ void loop() {
         printBits(adsData->formatedData.channel[0].mid);
         printBits(adsData->formatedData.channel[0].low);
         Serial.println("");
-        Serial.print("Bits in offset binary for channel 1: ");
-        Serial.println(sampleValue, BIN);
+        Serial.print("Decoded value for channel 1: ");
+        Serial.println(sampleValue);
     */
 
     // Read new data. We aren't in RDATAC mode
@@ -0,0 +1,267 @@
+/*
+    Micro-benchmarks of the hot paths of the driver on a computer, with the mocked HAL backend (see ads129xHalMock.h):
+      - isr.*: DRDY interruption in RDATAC mode (_privateReadDataFromChip_()). isr.capture is only the SPI read of the
+        frame into its slot, isr.frame the whole interruption (edge tracking, capture, status word tracking and publish)
+        and isr.publish the difference. ring.release is the consumer giving the slots back (pop()), which replaced the
+        clear of the slot in the interruption.
+      - decode.*: decoders of ads129xDecoder.h for the ADS_BITS_PER_CHANNEL of the build.
+      - registers.*: register helpers (commands sent to the mocked SPI, so only the code of the driver is measured).
+
+    The results are printed in stdout as one JSON object (the messages of the driver go to stderr):
+        {"chip": "ADS1298", "bitsPerChannel": 24, "frameSize": 27, ..., "results": [
+          {"name": "isr.frame", "unit": "ns/frame", "median": 41.2, "min": 40.8}, ...]}
+    Every benchmark is repeated REPETITIONS times. median is the one to compare, min shows how much noise there was.
+
+    Building (from the root of the library, one build per chip and bits per channel):
+        g++ -std=c++11 -O2 -I. -Iextras/benchmark -DADS_HAL_BACKEND=ADS_HAL_HOST_MOCK -DADS_CHIP_USED=ADS_1298 \
+            -DADS_BITS_PER_CHANNEL=24 extras/benchmark/ads129xBenchmark.cpp extras/benchmark/ads129xHalMock.cpp \
+            ads129xDriver.cpp ads129xWritePlan.cpp ads129xDecoder.cpp -o ads129xBenchmark
+    extras/benchmark/runBenchmarks.sh builds and runs all of them (six chips, 16 and 24 bits) and prints a JSON array.
+*/
+#include "ads129xDriver.h"
+#include "ads129xDecoder.h"
+#include "ads129xHalMock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace {
+
+const uint8_t REPETITIONS = 7;
+const uint64_t TARGET_RUN_NS = 20000000; // Every repetition takes ~20 ms
+const uint16_t DECODE_FRAMES = 256;
+
+const uint8_t CS_PIN = 10;
+const uint8_t DRDY_PIN = 2;
+
+uint64_t nowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// Prevent the compiler from removing the computation of a value that isn't used
+template <class T>
+void doNotOptimize(const T &value) {
+  __asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+
+boolean isFirstResult = true;
+
+void printResult(const char *name, const char *unit, double median, double min) {
+  printf("%s\n    {\"name\": \"%s\", \"unit\": \"%s\", \"median\": %.2f, \"min\": %.2f}", isFirstResult ? "" : ",", name, unit,
+         median, min);
+  isFirstResult = false;
+}
+
+int compareDoubles(const void *a, const void *b) {
+  double x = *(const double *) a, y = *(const double *) b;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// A benchmark does nOps operations (frames, calls, ...) and returns the ns that they took
+typedef uint64_t (*benchmark_t)(uint32_t nOps);
+
+void run(const char *name, const char *unit, benchmark_t benchmark, double *median = NULL) {
+  // Warm up and calibration: nOps for TARGET_RUN_NS
+  uint32_t nOps = 64;
+  uint64_t ns;
+  while ((ns = benchmark(nOps)) < TARGET_RUN_NS / 4 && nOps < (1UL << 30))
+    nOps *= 2;
+  nOps = (uint32_t) ((double) nOps * TARGET_RUN_NS / (ns > 0 ? ns : 1)) + 1;
+
+  double results[REPETITIONS];
+  for (uint8_t i = 0; i < REPETITIONS; i++)
+    results[i] = (double) benchmark(nOps) / nOps;
+  qsort(results, REPETITIONS, sizeof(double), compareDoubles);
+  printResult(name, unit, results[REPETITIONS / 2], results[0]);
+  if (median != NULL)
+    *median = results[REPETITIONS / 2];
+}
+
+ADS129xSensor sensor(CS_PIN, DRDY_PIN);
+ads_data_t frame; // Frame sent by the mocked chip
+ads_data_t decodeInput[DECODE_FRAMES];
+int32_t decodeOutput[DECODE_FRAMES * ADS_TOTAL_CHANNELS];
+float decodeOutputFloat[DECODE_FRAMES * ADS_TOTAL_CHANNELS];
+float lsb[ADS_TOTAL_CHANNELS];
+
+/* ======= DRDY interruption ============= */
+uint64_t benchmarkCapture(uint32_t nOps) {
+  ads_data_t slot;
+  uint64_t start = nowNs();
+  for (uint32_t i = 0; i < nOps; i++) {
+    ads::hal::spiBeginTransaction(CS_PIN, ADS_SPI_FRAME_READ_SPEED);
+    ads::hal::spiReceive(slot.rawData, _ADS_DATA_PACKAGE_SIZE);
+    ads::hal::spiEndTransaction(CS_PIN);
+    doNotOptimize(slot);
+  }
+  return nowNs() - start;
+}
+
+// The ring buffer is filled by the interruption and emptied by the consumer. Only the interruptions are timed
+uint64_t benchmarkIsr(uint32_t nOps) {
+  uint64_t ns = 0;
+  for (uint32_t done = 0; done < nOps; done += ADS_FRAME_BUFFER_SIZE) {
+    uint64_t start = nowNs();
+    for (uint16_t i = 0; i < ADS_FRAME_BUFFER_SIZE; i++)
+      ads::hal::mock::triggerDrdy();
+    ns += nowNs() - start;
+    sensor.pop(ADS_FRAME_BUFFER_SIZE);
+  }
+  return ns * nOps / ((nOps + ADS_FRAME_BUFFER_SIZE - 1) / ADS_FRAME_BUFFER_SIZE * ADS_FRAME_BUFFER_SIZE);
+}
+
+// The same, but only the consumer is timed
+uint64_t benchmarkRelease(uint32_t nOps) {
+  uint64_t ns = 0;
+  for (uint32_t done = 0; done < nOps; done += ADS_FRAME_BUFFER_SIZE) {
+    for (uint16_t i = 0; i < ADS_FRAME_BUFFER_SIZE; i++)
+      ads::hal::mock::triggerDrdy();
+    uint64_t start = nowNs();
+    for (uint16_t i = 0; i < ADS_FRAME_BUFFER_SIZE; i++)
+      sensor.pop();
+    ns += nowNs() - start;
+  }
+  return ns * nOps / ((nOps + ADS_FRAME_BUFFER_SIZE - 1) / ADS_FRAME_BUFFER_SIZE * ADS_FRAME_BUFFER_SIZE);
+}
+
+/* ======= Decoders ============= */
+uint64_t benchmarkDecodeInt(uint32_t nOps) {
+  uint64_t start = nowNs();
+  for (uint32_t done = 0; done < nOps; done += DECODE_FRAMES) {
+    ads::decoder::decodeFrames(decodeInput, DECODE_FRAMES, decodeOutput);
+    doNotOptimize(decodeOutput);
+  }
+  return (nowNs() - start) * nOps / ((nOps + DECODE_FRAMES - 1) / DECODE_FRAMES * DECODE_FRAMES);
+}
+
+uint64_t benchmarkDecodeFloat(uint32_t nOps) {
+  uint64_t start = nowNs();
+  for (uint32_t done = 0; done < nOps; done += DECODE_FRAMES) {
+    ads::decoder::decodeFrames(decodeInput, DECODE_FRAMES, lsb, decodeOutputFloat);
+    doNotOptimize(decodeOutputFloat);
+  }
+  return (nowNs() - start) * nOps / ((nOps + DECODE_FRAMES - 1) / DECODE_FRAMES * DECODE_FRAMES);
+}
+
+uint64_t benchmarkDecodeColumns(uint32_t nOps) {
+  uint64_t start = nowNs();
+  for (uint32_t done = 0; done < nOps; done += DECODE_FRAMES) {
+    ads::decoder::decodeFramesToColumns(decodeInput, DECODE_FRAMES, decodeOutput, DECODE_FRAMES);
+    doNotOptimize(decodeOutput);
+  }
+  return (nowNs() - start) * nOps / ((nOps + DECODE_FRAMES - 1) / DECODE_FRAMES * DECODE_FRAMES);
+}
+
+/* ======= Registers ============= */
+uint64_t benchmarkWriteRegister(uint32_t nOps) {
+  uint64_t start = nowNs();
+  for (uint32_t i = 0; i < nOps; i++)
+    sensor.writeRegister(ads::registers::config3::REG_ADDR, ads::registers::config3::RESET_VALUE | (i & 1));
+  return nowNs() - start;
+}
+
+uint64_t benchmarkReadAllRegisters(uint32_t nOps) {
+  byte registers[ads::registers::N_REGISTERS];
+  uint64_t start = nowNs();
+  for (uint32_t i = 0; i < nOps; i++) {
+    sensor.readAllRegisters(registers);
+    doNotOptimize(registers);
+  }
+  return nowNs() - start;
+}
+
+uint64_t benchmarkEnableChannelAndSetGain(uint32_t nOps) {
+  uint64_t start = nowNs();
+  for (uint32_t i = 0; i < nOps; i++)
+    sensor.enableChannelAndSetGain(1 + i % ADS_N_CHANNELS, (i & 8) ? ads::registers::chnSet::GAIN_12X : ads::registers::chnSet::GAIN_6X);
+  return nowNs() - start;
+}
+
+uint64_t benchmarkDisableChannel(uint32_t nOps) {
+  uint64_t start = nowNs();
+  for (uint32_t i = 0; i < nOps; i++)
+    sensor.disableChannel(1 + i % ADS_N_CHANNELS, (i & 8) != 0);
+  return nowNs() - start;
+}
+
+// All the channels are changed and written with one burst
+uint64_t benchmarkFlushChannels(uint32_t nOps) {
+  using namespace ads::registers::chnSet;
+  uint64_t start = nowNs();
+  for (uint32_t i = 0; i < nOps; i++) {
+    for (uint8_t c = 1; c <= ADS_N_CHANNELS; c++)
+      sensor.setRegisterShadow(_BASE_REG_ADDR + c, (i & 1) ? GAIN_12X : GAIN_6X);
+    sensor.flushRegisters();
+  }
+  return nowNs() - start;
+}
+
+const char * chipName() {
+  switch (ADS_CHIP_USED) {
+    case ADS_1294: return "ADS1294";
+    case ADS_1294R: return "ADS1294R";
+    case ADS_1296: return "ADS1296";
+    case ADS_1296R: return "ADS1296R";
+    case ADS_1298: return "ADS1298";
+    default: return "ADS1298R";
+  }
+}
+
+}
+
+int main() {
+  // Frame: valid status word and a different value in every channel
+  memset(&frame, 0, sizeof(frame));
+  for (uint8_t d = 0; d < ADS_DAISY_CHAIN_DEVICES; d++) {
+    frame.device[d].statusWord[0] = ads::STATUS_SYNC;
+    for (uint8_t c = 0; c < ADS_N_CHANNELS; c++) {
+      byte *bytes = (byte *) &frame.device[d].channel[c];
+      for (uint8_t b = 0; b < sizeof(frame.device[d].channel[c]); b++)
+        bytes[b] = 17 * (d * ADS_N_CHANNELS + c) + 31 * b + 5;
+    }
+  }
+  srand(1);
+  for (uint16_t i = 0; i < DECODE_FRAMES; i++) {
+    for (uint16_t b = 0; b < sizeof(ads_data_t); b++)
+      decodeInput[i].rawData[b] = rand();
+  }
+  for (uint8_t c = 0; c < ADS_TOTAL_CHANNELS; c++)
+    lsb[c] = 2.4f / 6 / (1L << (ADS_BITS_PER_CHANNEL - 1));
+
+  // begin() reads the ID register: RREG, count and the ID
+  const byte idResponse[3] = {0x00, 0x00, ads::chip_traits<ADS_CHIP_USED>::ID};
+  ads::hal::mock::setResponse(idResponse, sizeof(idResponse));
+  sensor.begin();
+
+  printf("{\"chip\": \"%s\", \"bitsPerChannel\": %d, \"frameSize\": %d, \"daisyChainDevices\": %d, \"frameBufferSize\": %d, "
+         "\"statusEventBufferSize\": %d, \"results\": [", chipName(), ADS_BITS_PER_CHANNEL, (int) _ADS_DATA_PACKAGE_SIZE,
+         ADS_DAISY_CHAIN_DEVICES, ADS_FRAME_BUFFER_SIZE, ADS_STATUS_EVENT_BUFFER_SIZE);
+
+  run("registers.writeRegister", "ns/call", benchmarkWriteRegister);
+  run("registers.readAllRegisters", "ns/call", benchmarkReadAllRegisters);
+  run("registers.enableChannelAndSetGain", "ns/call", benchmarkEnableChannelAndSetGain);
+  run("registers.disableChannel", "ns/call", benchmarkDisableChannel);
+  run("registers.flushAllChannels", "ns/call", benchmarkFlushChannels);
+
+  run("decode.int32", "ns/frame", benchmarkDecodeInt);
+  run("decode.float", "ns/frame", benchmarkDecodeFloat);
+  run("decode.columns.int32", "ns/frame", benchmarkDecodeColumns);
+
+  // The interruption reads frames in RDATAC mode
+  ads::hal::mock::setResponse(frame.rawData, _ADS_DATA_PACKAGE_SIZE);
+  sensor.sendSPICommandRDATAC();
+  double captureNs, isrNs;
+  run("isr.capture", "ns/frame", benchmarkCapture, &captureNs);
+  run("isr.frame", "ns/frame", benchmarkIsr, &isrNs);
+  printResult("isr.publish", "ns/frame", isrNs - captureNs, isrNs - captureNs);
+  run("ring.release", "ns/frame", benchmarkRelease);
+
+  ads_frame_counters_t counters;
+  sensor.getFrameCounters(&counters);
+  printf("\n  ], \"framesStored\": %u, \"framesDropped\": %u}\n", counters.framesStored, counters.framesDropped);
+  return 0;
+}
@@ -0,0 +1,155 @@
+// Mocked backend of the hardware abstraction layer (see ads129xHalMock.h)
+#include "ads129xHalMock.h"
+
+#if ADS_HAL_BACKEND == ADS_HAL_HOST_MOCK
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace {
+const uint16_t MAX_RESPONSE_BYTES = 256;
+byte response[MAX_RESPONSE_BYTES] = {0};
+uint16_t responseBytes = 0;
+uint16_t responseIndex = 0; // Next byte of response in the open transaction
+
+void (*drdyIsr)() = NULL;
+
+inline byte nextByte() {
+  return responseIndex < responseBytes ? response[responseIndex++] : 0x00;
+}
+}
+
+namespace ads {
+namespace hal {
+namespace mock {
+void setResponse(const byte *bytes, uint16_t nBytes) {
+  if (nBytes > MAX_RESPONSE_BYTES)
+    nBytes = MAX_RESPONSE_BYTES;
+  memcpy(response, bytes, nBytes);
+  responseBytes = nBytes;
+  responseIndex = 0;
+}
+
+void triggerDrdy() {
+  if (drdyIsr != NULL)
+    drdyIsr();
+}
+}
+
+/* ======= SPI ============= */
+void spiBegin() {}
+
+void spiBeginTransaction(uint8_t chipSelectPin, uint32_t clockHz) {
+  (void) chipSelectPin;
+  (void) clockHz;
+  responseIndex = 0;
+}
+
+void spiEndTransaction(uint8_t chipSelectPin) {
+  (void) chipSelectPin;
+}
+
+byte spiTransfer(byte data) {
+  (void) data;
+  return nextByte();
+}
+
+void spiTransfer(byte *buffer, uint16_t nBytes) {
+  for (uint16_t i = 0; i < nBytes; i++)
+    buffer[i] = nextByte();
+}
+
+void spiWrite(const byte *data, uint16_t nBytes) {
+  (void) data;
+  // The bytes received are skipped, like a real bus
+  responseIndex = responseIndex + nBytes < responseBytes ? responseIndex + nBytes : responseBytes;
+}
+
+void spiReceive(byte *buffer, uint16_t nBytes) {
+  // The usual case (a whole frame) is one copy
+  if (responseIndex + nBytes <= responseBytes) {
+    memcpy(buffer, response + responseIndex, nBytes);
+    responseIndex += nBytes;
+    return;
+  }
+  for (uint16_t i = 0; i < nBytes; i++)
+    buffer[i] = nextByte();
+}
+
+boolean spiTransferAsync(byte *buffer, uint16_t nBytes, void (*onComplete)()) {
+  (void) buffer;
+  (void) nBytes;
+  (void) onComplete;
+  return false; // The driver falls back to synchronous reads
+}
+
+/* ======= GPIO pins ============= */
+void setPinAsOutput(uint8_t pin) { (void) pin; }
+
+void setPinAsInput(uint8_t pin) { (void) pin; }
+
+void writePin(uint8_t pin, uint8_t level) {
+  (void) pin;
+  (void) level;
+}
+
+/* ======= Interrupts ============= */
+void attachDrdyInterrupt(uint8_t drdyPin, void (*isr)()) {
+  (void) drdyPin;
+  drdyIsr = isr;
+}
+
+void detachDrdyInterrupt(uint8_t drdyPin) {
+  (void) drdyPin;
+  drdyIsr = NULL;
+}
+
+void disableInterrupts() {}
+
+void enableInterrupts() {}
+
+/* ======= Time ============= */
+void delayMs(uint32_t ms) { (void) ms; }
+
+void delayUs(uint32_t us) { (void) us; }
+
+uint32_t micros() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t) ((uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000);
+}
+
+/* ======= Messages ============= */
+void print(const char *msg) {
+  fputs(msg, stderr);
+}
+
+void println(const char *msg) {
+  fputs(msg, stderr);
+  fputc('\n', stderr);
+}
+
+void println(uint32_t value, uint8_t base) {
+  char digits[33];
+  uint8_t n = 0;
+  do {
+    uint8_t digit = value % base;
+    digits[n++] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    value /= base;
+  } while (value > 0);
+  while (n > 0)
+    fputc(digits[--n], stderr);
+  fputc('\n', stderr);
+}
+
+void halt() {
+  fflush(stderr);
+  abort();
+}
+
+} // End of the hal namespace
+} // End of the ads namespace
+
+#endif /* ADS_HAL_BACKEND == ADS_HAL_HOST_MOCK */
@@ -0,0 +1,32 @@
+/*
+    Mocked backend of the hardware abstraction layer (see ads129xHal.h) used by the benchmarks. Build with
+    -DADS_HAL_BACKEND=ADS_HAL_HOST_MOCK.
+
+    Nothing is simulated, so every function is as fast as possible and a benchmark measures only the code of the driver:
+      - SPI: the bytes received are taken from the response set with setResponse(), starting again at its first byte in
+        every transaction (for example, a frame in RDATAC mode or {0, 0, ID} to read the ID register). Sent bytes are
+        ignored.
+      - Interruptions: the DRDY interruption is only called by triggerDrdy(), like if DRDY had fallen. It isn't masked
+        by the open SPI transactions or disableInterrupts() (benchmarks are single-threaded).
+      - Time: delays return immediately and micros() is the monotonic clock of the computer.
+*/
+#ifndef _ADS129X_HAL_MOCK_H_
+#define _ADS129X_HAL_MOCK_H_
+
+#include "ads129xHal.h"
+
+namespace ads {
+namespace hal {
+namespace mock {
+
+// Bytes received in every SPI transaction (they are copied, up to 256 bytes). If a transaction receives more bytes,
+// they are 0x00
+void setResponse(const byte *response, uint16_t nBytes);
+// Call the DRDY interruption (if one is attached)
+void triggerDrdy();
+
+} // End of the mock namespace
+} // End of the hal namespace
+} // End of the ads namespace
+
+#endif /* _ADS129X_HAL_MOCK_H_ */
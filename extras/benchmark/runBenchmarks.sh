@@ -0,0 +1,28 @@
+#!/bin/sh
+# Build and run ads129xBenchmark.cpp for the six ADS models with 16 and 24 bits per channel. The results are printed in
+# stdout as a JSON array (one object per build, see ads129xBenchmark.cpp). Run it from any directory:
+#     extras/benchmark/runBenchmarks.sh > results.json
+# CXX and CXXFLAGS can be set to compare compilers and options (default: g++ and -O2).
+set -e
+
+LIBRARY_DIR=$(cd "$(dirname "$0")/../.." && pwd)
+BUILD_DIR=$(mktemp -d)
+trap 'rm -rf "$BUILD_DIR"' EXIT
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2}
+
+echo "["
+SEPARATOR=""
+for CHIP in ADS_1294 ADS_1294R ADS_1296 ADS_1296R ADS_1298 ADS_1298R; do
+  for BITS in 16 24; do
+    PROGRAM="$BUILD_DIR/benchmark_${CHIP}_${BITS}"
+    $CXX -std=c++11 $CXXFLAGS -I"$LIBRARY_DIR" -I"$LIBRARY_DIR/extras/benchmark" -DADS_HAL_BACKEND=ADS_HAL_HOST_MOCK \
+      -DADS_CHIP_USED=$CHIP -DADS_BITS_PER_CHANNEL=$BITS "$LIBRARY_DIR/extras/benchmark/ads129xBenchmark.cpp" \
+      "$LIBRARY_DIR/extras/benchmark/ads129xHalMock.cpp" "$LIBRARY_DIR/ads129xDriver.cpp" "$LIBRARY_DIR/ads129xWritePlan.cpp" "$LIBRARY_DIR/ads129xDecoder.cpp" \
+      "$LIBRARY_DIR/ads129xHalArduino.cpp" -o "$PROGRAM"
+    printf "%s" "$SEPARATOR"
+    "$PROGRAM" 2> /dev/null
+    SEPARATOR=","
+  done
+done
+echo "]"
@@ -0,0 +1,601 @@
+// Linux backend of the hardware abstraction layer (see ads129xHalLinux.h)
+#include "ads129xHalLinux.h"
+
+#if ADS_HAL_BACKEND == ADS_HAL_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+namespace {
+int realOpen(const char *path, int flags) {
+  return ::open(path, flags);
+}
+
+int realClose(int fd) {
+  return ::close(fd);
+}
+
+int realIoctl(int fd, unsigned long request, void *arg) {
+  return ::ioctl(fd, request, arg);
+}
+
+const ads_linux_syscalls_t REAL_SYSCALLS = {realOpen, realClose, realIoctl};
+ads_linux_syscalls_t sys = REAL_SYSCALLS;
+
+const uint16_t N_PINS = 256; // Pins are uint8_t
+
+struct spi_device_t {
+  uint8_t chipSelectPin;
+  int fd;
+};
+spi_device_t spiDevices[ADS_MAX_SENSORS];
+uint8_t nSpiDevices = 0;
+
+int gpioChipFd = -1;
+int lineFds[N_PINS]; // File descriptor of the requested line of each pin. -1 if it isn't requested
+boolean areLineFdsCleared = false;
+
+// DRDY lines watched by the reader thread
+struct drdy_line_t {
+  uint8_t pin;
+  int fd;
+  void (*isr)();
+};
+drdy_line_t drdyLines[ADS_MAX_SENSORS];
+uint8_t nDrdyLines = 0;
+
+// Interrupt context. The reader thread holds interruptMutex while it calls an interruption. Your code holds it while a
+// SPI transaction is open or interrupts are disabled (it's recursive: the interruption opens SPI transactions too)
+pthread_mutex_t interruptMutex;
+boolean isInterruptMutexReady = false;
+pthread_t readerThread;
+boolean isReaderRunning = false;
+volatile boolean stopReader = false;
+int wakeUpPipe[2] = {-1, -1}; // Written to make the reader thread rebuild its list of lines or stop
+int readerPriority = 0;
+
+// Generations of the list of DRDY lines: linesGeneration changes with the list (interruptMutex held) and readerGeneration
+// is the one that the reader thread took (rebuildMutex held). A line isn't closed until the reader thread has taken a
+// list without it, so poll() never waits on a closed (or reused) file descriptor
+uint32_t linesGeneration = 0;
+uint32_t readerGeneration = 0;
+pthread_mutex_t rebuildMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t rebuildCondition = PTHREAD_COND_INITIALIZER;
+
+// waitForInterrupt()
+pthread_mutex_t waitMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t waitCondition = PTHREAD_COND_INITIALIZER;
+uint32_t interruptCount = 0;
+
+// While the reader thread calls an interruption, its micros() is shifted back by the wake-up latency of the thread, so
+// the interruption starts at the time of the DRDY edge given by the kernel. Otherwise, a late wake-up would look like a
+// lost DRDY edge to the driver and the frame timestamps would have the scheduling jitter
+thread_local uint64_t isrClockShiftNs = 0;
+
+// Open transaction: transfers queued until the bytes received are needed or the transaction ends
+int transactionFd = -1;
+uint32_t transactionClockHz = 0;
+struct spi_ioc_transfer queue[ads::hal::linuxdev::MAX_QUEUED_TRANSFERS];
+uint8_t nQueued = 0;
+byte queuedBytes[ads::hal::linuxdev::MAX_QUEUED_BYTES]; // Bytes of the spiWrite() transfers
+uint16_t nQueuedBytes = 0;
+
+uint64_t monotonicNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now); // Clock of the GPIO edge events
+  return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void fail(const char *what) {
+  fprintf(stderr, "Linux HAL: %s: %s\n", what, strerror(errno));
+  ads::hal::halt();
+}
+
+void clearLineFds() {
+  if (areLineFdsCleared)
+    return;
+  for (uint16_t i = 0; i < N_PINS; i++)
+    lineFds[i] = -1;
+  areLineFdsCleared = true;
+}
+
+void initInterruptMutex() {
+  if (isInterruptMutexReady)
+    return;
+  pthread_mutexattr_t attributes;
+  pthread_mutexattr_init(&attributes);
+  pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&interruptMutex, &attributes);
+  pthread_mutexattr_destroy(&attributes);
+  isInterruptMutexReady = true;
+}
+
+boolean isChipSelectPin(uint8_t pin) {
+  for (uint8_t i = 0; i < nSpiDevices; i++) {
+    if (spiDevices[i].chipSelectPin == pin)
+      return true;
+  }
+  return false;
+}
+
+/* ======= SPI queue ============= */
+// Send the queued transfers in one message (CS stays low from the first one to the last one)
+void flushQueue() {
+  if (nQueued == 0)
+    return;
+  if (sys.ioctl(transactionFd, SPI_IOC_MESSAGE(nQueued), queue) < 0)
+    fail("SPI_IOC_MESSAGE");
+  nQueued = 0;
+  nQueuedBytes = 0;
+}
+
+// New transfer at the end of the queue. tx or rx can be NULL (zeros are sent / the bytes received are ignored)
+void queueTransfer(const byte *tx, byte *rx, uint32_t nBytes) {
+  if (nQueued == ads::hal::linuxdev::MAX_QUEUED_TRANSFERS)
+    flushQueue();
+  struct spi_ioc_transfer &transfer = queue[nQueued++];
+  memset(&transfer, 0, sizeof(transfer));
+  transfer.tx_buf = (unsigned long) tx;
+  transfer.rx_buf = (unsigned long) rx;
+  transfer.len = nBytes;
+  transfer.speed_hz = transactionClockHz;
+  transfer.bits_per_word = 8;
+}
+
+void sleepUs(uint64_t us) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  uint64_t ns = (uint64_t) deadline.tv_nsec + us * 1000;
+  deadline.tv_sec += ns / 1000000000;
+  deadline.tv_nsec = ns % 1000000000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR);
+}
+
+void delayInTransaction(uint64_t us) {
+  // Only the thread that opened the transaction touches its queue (the reader thread can be in its own transaction).
+  // interruptMutex is recursive: trylock succeeds if this thread holds it or nobody does (then there's no transaction)
+  if (isInterruptMutexReady && pthread_mutex_trylock(&interruptMutex) == 0) {
+    // The kernel waits after the last queued transfer, before the next one
+    if (transactionFd >= 0 && nQueued > 0 && queue[nQueued - 1].delay_usecs + us <= 0xFFFF) {
+      queue[nQueued - 1].delay_usecs += us;
+      pthread_mutex_unlock(&interruptMutex);
+      return;
+    }
+    if (transactionFd >= 0)
+      flushQueue();
+    pthread_mutex_unlock(&interruptMutex);
+  }
+  sleepUs(us);
+}
+
+/* ======= GPIO lines ============= */
+void releaseLine(uint8_t pin) {
+  if (lineFds[pin] >= 0) {
+    sys.close(lineFds[pin]);
+    lineFds[pin] = -1;
+  }
+}
+
+// Request the line pin with flags (GPIO_V2_LINE_FLAG_*). Return its file descriptor
+int requestLine(uint8_t pin, uint64_t flags) {
+  if (gpioChipFd < 0) {
+    errno = ENODEV;
+    fail("no GPIO chip (see setGpioChip())");
+  }
+  clearLineFds();
+  releaseLine(pin);
+
+  struct gpio_v2_line_request request;
+  memset(&request, 0, sizeof(request));
+  request.offsets[0] = pin;
+  request.num_lines = 1;
+  strncpy(request.consumer, "ads129x", sizeof(request.consumer) - 1);
+  request.config.flags = flags;
+  if (sys.ioctl(gpioChipFd, GPIO_V2_GET_LINE_IOCTL, &request) < 0)
+    fail("GPIO_V2_GET_LINE_IOCTL");
+  lineFds[pin] = request.fd;
+  return request.fd;
+}
+
+void wakeUpReader() {
+  byte b = 0;
+  if (write(wakeUpPipe[1], &b, 1) < 0 && errno != EAGAIN)
+    fail("wake-up pipe");
+}
+
+/* ======= Reader thread ============= */
+void *readerMain(void *) {
+  struct pollfd fds[1 + ADS_MAX_SENSORS];
+  void (*isrs[ADS_MAX_SENSORS])();
+  while (!stopReader) {
+    // The lines can change (attachDrdyInterrupt() and detachDrdyInterrupt()) -> the list is taken every time
+    pthread_mutex_lock(&interruptMutex);
+    uint8_t nLines = nDrdyLines;
+    fds[0].fd = wakeUpPipe[0];
+    fds[0].events = POLLIN;
+    for (uint8_t i = 0; i < nLines; i++) {
+      fds[1 + i].fd = drdyLines[i].fd;
+      fds[1 + i].events = POLLIN;
+      isrs[i] = drdyLines[i].isr;
+    }
+    uint32_t generation = linesGeneration;
+    pthread_mutex_unlock(&interruptMutex);
+
+    // The file descriptors of the previous list aren't used anymore
+    pthread_mutex_lock(&rebuildMutex);
+    readerGeneration = generation;
+    pthread_cond_broadcast(&rebuildCondition);
+    pthread_mutex_unlock(&rebuildMutex);
+
+    if (poll(fds, 1 + nLines, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      fail("poll");
+    }
+    if (fds[0].revents & POLLIN) {
+      byte discarded[16];
+      while (read(wakeUpPipe[0], discarded, sizeof(discarded)) > 0);
+      continue;
+    }
+
+    for (uint8_t i = 0; i < nLines; i++) {
+      if (!(fds[1 + i].revents & POLLIN))
+        continue;
+      // All the edges since the last call -> one call (the driver counts the merged edges)
+      struct gpio_v2_line_event events[16];
+      uint64_t edgeNs = 0;
+      ssize_t nRead;
+      while ((nRead = read(fds[1 + i].fd, events, sizeof(events))) > 0) {
+        edgeNs = events[nRead / sizeof(events[0]) - 1].timestamp_ns;
+        if (nRead < (ssize_t) sizeof(events))
+          break;
+      }
+      pthread_mutex_lock(&interruptMutex);
+      // It could have been detached meanwhile
+      if (i < nDrdyLines && drdyLines[i].isr == isrs[i]) {
+        uint64_t nowNs = monotonicNs();
+        isrClockShiftNs = edgeNs != 0 && edgeNs < nowNs ? nowNs - edgeNs : 0;
+        isrs[i]();
+        isrClockShiftNs = 0;
+      }
+      pthread_mutex_unlock(&interruptMutex);
+
+      pthread_mutex_lock(&waitMutex);
+      interruptCount++;
+      pthread_cond_broadcast(&waitCondition);
+      pthread_mutex_unlock(&waitMutex);
+    }
+  }
+  return NULL;
+}
+
+void startReader() {
+  if (isReaderRunning)
+    return;
+  if (pipe(wakeUpPipe) < 0)
+    fail("pipe");
+  fcntl(wakeUpPipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(wakeUpPipe[1], F_SETFL, O_NONBLOCK);
+  stopReader = false;
+  if (pthread_create(&readerThread, NULL, readerMain, NULL) != 0)
+    fail("pthread_create");
+  isReaderRunning = true;
+  ads::hal::linuxdev::setReaderPriority(readerPriority);
+}
+
+// Make the reader thread take the list of lines of generation (or a newer one) and wait until it has taken it
+void rebuildReaderLines(uint32_t generation) {
+  wakeUpReader();
+  pthread_mutex_lock(&rebuildMutex);
+  while ((int32_t) (readerGeneration - generation) < 0)
+    pthread_cond_wait(&rebuildCondition, &rebuildMutex);
+  pthread_mutex_unlock(&rebuildMutex);
+}
+
+void stopReaderThread() {
+  if (!isReaderRunning)
+    return;
+  stopReader = true;
+  wakeUpReader();
+  pthread_join(readerThread, NULL);
+  ::close(wakeUpPipe[0]);
+  ::close(wakeUpPipe[1]);
+  wakeUpPipe[0] = wakeUpPipe[1] = -1;
+  isReaderRunning = false;
+}
+}
+
+namespace ads {
+namespace hal {
+namespace linuxdev {
+boolean setGpioChip(const char *path) {
+  clearLineFds();
+  if (gpioChipFd >= 0)
+    sys.close(gpioChipFd);
+  gpioChipFd = sys.open(path, O_RDWR | O_CLOEXEC);
+  return gpioChipFd >= 0;
+}
+
+boolean addSpiDevice(uint8_t chipSelectPin, const char *path) {
+  if (nSpiDevices == ADS_MAX_SENSORS)
+    return false;
+  int fd = sys.open(path, O_RDWR | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  // See page 17, section 7.7 Switching Characteristics: Serial Interface, in the datasheet (CPOL = 0, CPHA = 1)
+  uint8_t mode = SPI_MODE_1;
+  uint8_t bitsPerWord = 8;
+  if (sys.ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0 || sys.ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bitsPerWord) < 0) {
+    sys.close(fd);
+    return false;
+  }
+  spiDevices[nSpiDevices].chipSelectPin = chipSelectPin;
+  spiDevices[nSpiDevices].fd = fd;
+  nSpiDevices++;
+  return true;
+}
+
+void setReaderPriority(int priority) {
+  readerPriority = priority;
+  if (!isReaderRunning)
+    return;
+  struct sched_param param;
+  memset(&param, 0, sizeof(param));
+  param.sched_priority = priority;
+  int error = pthread_setschedparam(readerThread, priority > 0 ? SCHED_FIFO : SCHED_OTHER, &param);
+  if (error != 0)
+    fprintf(stderr, "Linux HAL: the reader thread can't have priority %d: %s\n", priority, strerror(error));
+}
+
+boolean waitForInterrupt(uint32_t timeoutMs) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline); // Clock of pthread_cond_timedwait()
+  uint64_t ns = (uint64_t) deadline.tv_nsec + (uint64_t) timeoutMs * 1000000;
+  deadline.tv_sec += ns / 1000000000;
+  deadline.tv_nsec = ns % 1000000000;
+
+  pthread_mutex_lock(&waitMutex);
+  uint32_t count = interruptCount;
+  int error = 0;
+  while (interruptCount == count && error == 0)
+    error = pthread_cond_timedwait(&waitCondition, &waitMutex, &deadline);
+  boolean interrupted = interruptCount != count;
+  pthread_mutex_unlock(&waitMutex);
+  return interrupted;
+}
+
+void close() {
+  stopReaderThread();
+  nDrdyLines = 0;
+  clearLineFds();
+  for (uint16_t pin = 0; pin < N_PINS; pin++)
+    releaseLine(pin);
+  for (uint8_t i = 0; i < nSpiDevices; i++)
+    sys.close(spiDevices[i].fd);
+  nSpiDevices = 0;
+  if (gpioChipFd >= 0)
+    sys.close(gpioChipFd);
+  gpioChipFd = -1;
+}
+
+void setSyscalls(const ads_linux_syscalls_t *syscalls) {
+  sys = syscalls != NULL ? *syscalls : REAL_SYSCALLS;
+}
+}
+
+/* ======= SPI ============= */
+void spiBegin() {
+  initInterruptMutex();
+}
+
+void spiBeginTransaction(uint8_t chipSelectPin, uint32_t clockHz) {
+  // The reader thread can't call the interruption until the transaction ends
+  pthread_mutex_lock(&interruptMutex);
+  transactionFd = -1;
+  for (uint8_t i = 0; i < nSpiDevices; i++) {
+    if (spiDevices[i].chipSelectPin == chipSelectPin)
+      transactionFd = spiDevices[i].fd;
+  }
+  if (transactionFd < 0) {
+    errno = ENODEV;
+    fail("no spidev device for the CS pin (see addSpiDevice())");
+  }
+  transactionClockHz = clockHz;
+}
+
+void spiEndTransaction(uint8_t chipSelectPin) {
+  (void) chipSelectPin;
+  flushQueue();
+  transactionFd = -1;
+  pthread_mutex_unlock(&interruptMutex);
+}
+
+byte spiTransfer(byte data) {
+  byte received;
+  queueTransfer(&data, &received, 1);
+  flushQueue();
+  return received;
+}
+
+void spiTransfer(byte *buffer, uint16_t nBytes) {
+  queueTransfer(buffer, buffer, nBytes);
+  flushQueue();
+}
+
+void spiWrite(const byte *data, uint16_t nBytes) {
+  if (nBytes > linuxdev::MAX_QUEUED_BYTES) { // Too long to be copied
+    queueTransfer(data, NULL, nBytes);
+    flushQueue();
+    return;
+  }
+  // The queue is sent before the copy if the bytes or a new transfer don't fit: flushQueue() empties queuedBytes
+  if (nQueuedBytes + nBytes > linuxdev::MAX_QUEUED_BYTES || nQueued == linuxdev::MAX_QUEUED_TRANSFERS)
+    flushQueue();
+  byte *copy = queuedBytes + nQueuedBytes;
+  memcpy(copy, data, nBytes);
+  nQueuedBytes += nBytes;
+
+  // Consecutive writes without delay between them are one transfer (for example, WREG command and its registers)
+  struct spi_ioc_transfer *last = nQueued > 0 ? &queue[nQueued - 1] : NULL;
+  if (last != NULL && last->rx_buf == 0 && last->delay_usecs == 0 && last->tx_buf + last->len == (unsigned long) copy)
+    last->len += nBytes;
+  else
+    queueTransfer(copy, NULL, nBytes);
+}
+
+void spiReceive(byte *buffer, uint16_t nBytes) {
+  queueTransfer(NULL, buffer, nBytes); // No transmit buffer -> zeros are sent
+  flushQueue();
+}
+
+// The reader thread reads the frames synchronously: the interruption doesn't block your code
+boolean spiTransferAsync(byte *buffer, uint16_t nBytes, void (*onComplete)()) {
+  (void) buffer;
+  (void) nBytes;
+  (void) onComplete;
+  return false;
+}
+
+/* ======= GPIO pins ============= */
+// The kernel drives the CS pins of the spidev devices -> they aren't GPIO lines
+void setPinAsOutput(uint8_t pin) {
+  if (!isChipSelectPin(pin))
+    requestLine(pin, GPIO_V2_LINE_FLAG_OUTPUT);
+}
+
+void setPinAsInput(uint8_t pin) {
+  if (!isChipSelectPin(pin))
+    requestLine(pin, GPIO_V2_LINE_FLAG_INPUT);
+}
+
+void writePin(uint8_t pin, uint8_t level) {
+  if (isChipSelectPin(pin))
+    return;
+  clearLineFds();
+  if (lineFds[pin] < 0)
+    requestLine(pin, GPIO_V2_LINE_FLAG_OUTPUT);
+  struct gpio_v2_line_values values;
+  memset(&values, 0, sizeof(values));
+  values.mask = 1;
+  values.bits = level == HIGH ? 1 : 0;
+  if (sys.ioctl(lineFds[pin], GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0)
+    fail("GPIO_V2_LINE_SET_VALUES_IOCTL");
+}
+
+/* ======= Interrupts ============= */
+void attachDrdyInterrupt(uint8_t drdyPin, void (*isr)()) {
+  initInterruptMutex();
+  // The line is requested again below -> the reader thread must stop using the current one first
+  for (uint8_t i = 0; i < nDrdyLines; i++) {
+    if (drdyLines[i].pin == drdyPin) {
+      detachDrdyInterrupt(drdyPin);
+      break;
+    }
+  }
+  int fd = requestLine(drdyPin, GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_FALLING);
+  fcntl(fd, F_SETFL, O_NONBLOCK); // The reader thread reads all the pending events
+
+  pthread_mutex_lock(&interruptMutex);
+  uint8_t i = 0;
+  while (i < nDrdyLines && drdyLines[i].pin != drdyPin)
+    i++;
+  if (i == nDrdyLines) {
+    if (nDrdyLines == ADS_MAX_SENSORS) {
+      errno = ENOSPC;
+      fail("more DRDY lines than ADS_MAX_SENSORS");
+    }
+    nDrdyLines++;
+  }
+  drdyLines[i].pin = drdyPin;
+  drdyLines[i].fd = fd;
+  drdyLines[i].isr = isr;
+  linesGeneration++;
+  pthread_mutex_unlock(&interruptMutex);
+
+  startReader();
+  wakeUpReader();
+}
+
+// It mustn't be called with interrupts disabled or a SPI transaction open: the reader thread could be waiting to call
+// an interruption and it wouldn't take the new list of lines
+void detachDrdyInterrupt(uint8_t drdyPin) {
+  pthread_mutex_lock(&interruptMutex);
+  for (uint8_t i = 0; i < nDrdyLines; i++) {
+    if (drdyLines[i].pin == drdyPin) {
+      drdyLines[i] = drdyLines[--nDrdyLines];
+      break;
+    }
+  }
+  uint32_t generation = ++linesGeneration;
+  pthread_mutex_unlock(&interruptMutex);
+  // The reader thread could be in poll() with the file descriptor -> it's closed after the thread has taken the new list
+  if (nDrdyLines == 0)
+    stopReaderThread();
+  else if (isReaderRunning)
+    rebuildReaderLines(generation);
+  releaseLine(drdyPin);
+}
+
+void disableInterrupts() {
+  pthread_mutex_lock(&interruptMutex);
+}
+
+void enableInterrupts() {
+  pthread_mutex_unlock(&interruptMutex);
+}
+
+/* ======= Time ============= */
+void delayMs(uint32_t ms) {
+  delayInTransaction((uint64_t) ms * 1000);
+}
+
+void delayUs(uint32_t us) {
+  delayInTransaction(us);
+}
+
+uint32_t micros() {
+  return (uint32_t) ((monotonicNs() - isrClockShiftNs) / 1000);
+}
+
+/* ======= Messages ============= */
+void print(const char *msg) {
+  fputs(msg, stdout);
+}
+
+void println(const char *msg) {
+  puts(msg);
+}
+
+void println(uint32_t value, uint8_t base) {
+  char digits[33];
+  uint8_t n = 0;
+  do {
+    uint8_t digit = value % base;
+    digits[n++] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    value /= base;
+  } while (value > 0);
+  while (n > 0)
+    putchar(digits[--n]);
+  putchar('\n');
+}
+
+void halt() {
+  fflush(stdout);
+  abort();
+}
+
+} // End of the hal namespace
+} // End of the ads namespace
+
+#endif /* ADS_HAL_BACKEND == ADS_HAL_LINUX */
@@ -0,0 +1,91 @@
+/*
+    Linux backend of the hardware abstraction layer (see ads129xHal.h) for gateways and single board computers (Cortex-A
+    boards, Raspberry Pi, ...). Build with -DADS_HAL_BACKEND=ADS_HAL_LINUX.
+
+      - SPI: /dev/spidevB.C devices, one per CS pin (see addSpiDevice()). The kernel drives CS, so the CS pin given to
+        ADS129xSensor is only the key of its device. The bytes of spiWrite() are queued and sent with one SPI_IOC_MESSAGE
+        ioctl together with the next transfer that receives bytes or when the transaction ends. The delays between them
+        are done by the kernel (delay_usecs of spi_ioc_transfer). So a frame read, a register read or flushRegisters()
+        with several WREG bursts and the wait after CONFIG1 is one system call.
+      - Pins: lines of one GPIO character device (see setGpioChip()). The pin numbers given to ADS129xSensor are the
+        offsets of the lines. It needs the GPIO uAPI v2 (Linux 5.10 or later).
+      - Interrupt context: a reader thread waits for the falling edges of the DRDY lines (edge events of the GPIO
+        character device) and calls the DRDY interruption. The edges that arrive while it's masked are merged in one
+        call, like the pending flag of a microcontroller (the driver counts the merged edges from the DRDY period). A
+        recursive mutex masks the reader thread while a SPI transaction is open or interrupts are disabled. The thread
+        can have realtime priority (see setReaderPriority()).
+      - Consumers read the frames from the ring buffer as usual (acquireFrames(), ...). waitForInterrupt() blocks a
+        consumer thread until the next DRDY interruption, so it doesn't need to poll.
+      - Time: micros() is CLOCK_MONOTONIC and the delays sleep (clock_nanosleep()). Inside the DRDY interruption, micros()
+        starts at the kernel timestamp of the edge, so the frame timestamps and the lost edge detection of the driver
+        don't suffer the wake-up latency of the reader thread.
+    Asynchronous frame reads aren't supported: with ADS_ASYNC_FRAME_READ, frames are read synchronously by the reader thread.
+
+    Example (ADS on /dev/spidev0.0, DRDY on line 25 and RESET on line 24 of /dev/gpiochip0, CS pin 8 is only a key):
+        ads::hal::linuxdev::setGpioChip("/dev/gpiochip0");
+        ads::hal::linuxdev::addSpiDevice(8, "/dev/spidev0.0");
+        ads::hal::linuxdev::setReaderPriority(80); // SCHED_FIFO (needs CAP_SYS_NICE)
+        ADS129xSensor sensor(8, 25, 24);
+        sensor.begin();
+        ... // Configuration, START and RDATAC
+        while (running) {
+          ads::hal::linuxdev::waitForInterrupt(100);
+          ads_frame_span_t span;
+          while (sensor.acquireFrames(&span)) {
+            ... // span.nFrames frames
+            sensor.releaseFrames(&span);
+          }
+        }
+        sensor.end();
+        ads::hal::linuxdev::close();
+
+    Building (from the root of the library):
+        g++ -std=c++11 -O2 -I. -Iextras/linux -DADS_HAL_BACKEND=ADS_HAL_LINUX yourProgram.cpp ads129xDriver.cpp \
+            ads129xWritePlan.cpp ads129xDecoder.cpp ads129xHalArduino.cpp extras/linux/ads129xHalLinux.cpp -pthread -o yourProgram
+
+    Without the devices (for example, a normal Linux computer), ads129xLinuxFake.h replaces the system calls of the backend
+    with a fake spidev/GPIO pair connected to the ADS chip simulator.
+*/
+#ifndef _ADS129X_HAL_LINUX_H_
+#define _ADS129X_HAL_LINUX_H_
+
+#include "ads129xHal.h"
+
+// System calls used by the backend to reach the devices (see ads::hal::linuxdev::setSyscalls())
+typedef struct {
+  int (*open)(const char *path, int flags);
+  int (*close)(int fd);
+  int (*ioctl)(int fd, unsigned long request, void *arg);
+} ads_linux_syscalls_t;
+
+namespace ads {
+namespace hal {
+namespace linuxdev {
+
+// Maximum number of transfers and bytes queued by spiWrite() in a transaction. When the queue is full, it's sent
+const uint8_t MAX_QUEUED_TRANSFERS = 16;
+const uint16_t MAX_QUEUED_BYTES = 256;
+
+// GPIO character device (for example, "/dev/gpiochip0") whose lines are the pins. Return false if it can't be opened
+boolean setGpioChip(const char *path);
+// spidev device (for example, "/dev/spidev0.0") of the ADS129xSensor with chipSelectPin. Up to ADS_MAX_SENSORS devices.
+// Return false if it can't be opened or configured (mode 1, 8 bits per word)
+boolean addSpiDevice(uint8_t chipSelectPin, const char *path);
+// SCHED_FIFO priority (1 to 99) of the reader thread. 0 (default) -> normal scheduling. If it's called before begin(), it's
+// applied when the thread starts. A warning is printed if the process isn't allowed to use it
+void setReaderPriority(int priority);
+// Wait until the DRDY interruption is called or timeoutMs milliseconds. Return false on timeout
+boolean waitForInterrupt(uint32_t timeoutMs);
+// Stop the reader thread and close every device. Call it after ADS129xSensor::end()
+void close();
+
+// Replace the system calls used to reach the devices (NULL -> the ones of the C library). Call it before setGpioChip()
+// and addSpiDevice(). The reader thread uses poll() and read() with the file descriptors given by the GPIO_V2_GET_LINE_IOCTL
+// ioctl, so they must be real file descriptors (for example, pipes)
+void setSyscalls(const ads_linux_syscalls_t *syscalls);
+
+} // End of the linuxdev namespace
+} // End of the hal namespace
+} // End of the ads namespace
+
+#endif /* _ADS129X_HAL_LINUX_H_ */
@@ -0,0 +1,265 @@
+// Fake spidev and GPIO character devices connected to the ADS chip simulator (see ads129xLinuxFake.h)
+#include "ads129xLinuxFake.h"
+
+#if ADS_HAL_BACKEND == ADS_HAL_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+namespace {
+enum fake_fd_kind_t { FD_FREE, FD_SPI, FD_GPIO_CHIP, FD_LINE };
+
+// What each fake file descriptor is
+struct fake_fd_t {
+  int fd;
+  fake_fd_kind_t kind;
+  uint8_t pin; // Line offset (FD_LINE)
+  int writeFd; // Write end of the pipe of a line (FD_LINE)
+  boolean isDrdy; // Line requested with GPIO_V2_LINE_FLAG_EDGE_FALLING (FD_LINE)
+};
+
+const uint8_t MAX_FAKE_FDS = 32;
+fake_fd_t fakeFds[MAX_FAKE_FDS];
+
+ADS129xChipSimulator chip;
+int drdyWriteFd = -1; // Write end of the pipe of the DRDY line. -1 if DRDY isn't requested
+uint32_t drdyEvents = 0;
+ads_linux_fake_stats_t stats;
+
+// The simulator is used by the ticker thread and by the threads that make system calls
+pthread_mutex_t chipMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_t tickerThread;
+volatile boolean stopTicker = false;
+boolean isInstalled = false;
+uint64_t originNs; // CLOCK_MONOTONIC when the simulator was powered on
+
+uint64_t monotonicNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// Advance the simulator to the real time (SPI bytes and delays can put it ahead. Then, it waits)
+void catchUp() {
+  uint64_t elapsedNs = monotonicNs() - originNs;
+  if (elapsedNs > chip.getNanoseconds())
+    chip.advanceNanoseconds(elapsedNs - chip.getNanoseconds());
+}
+
+void *tickerMain(void *) {
+  while (!stopTicker) {
+    struct timespec period = {0, _ADS_LINUX_FAKE_TICK_US * 1000};
+    nanosleep(&period, NULL);
+    pthread_mutex_lock(&chipMutex);
+    catchUp();
+    pthread_mutex_unlock(&chipMutex);
+  }
+  return NULL;
+}
+
+void drdyFalling(ADS129xChipSimulator *) {
+  if (drdyWriteFd < 0)
+    return;
+  struct gpio_v2_line_event event;
+  memset(&event, 0, sizeof(event));
+  event.timestamp_ns = originNs + chip.getNanoseconds(); // Time of the edge in the simulator
+  event.id = GPIO_V2_LINE_EVENT_FALLING_EDGE;
+  event.seqno = event.line_seqno = ++drdyEvents;
+  // Like the kernel, the event is lost if nobody reads them
+  if (write(drdyWriteFd, &event, sizeof(event)) < 0) {}
+}
+
+fake_fd_t *findFakeFd(int fd) {
+  for (uint8_t i = 0; i < MAX_FAKE_FDS; i++) {
+    if (fakeFds[i].kind != FD_FREE && fakeFds[i].fd == fd)
+      return &fakeFds[i];
+  }
+  return NULL;
+}
+
+fake_fd_t *newFakeFd(int fd, fake_fd_kind_t kind) {
+  for (uint8_t i = 0; i < MAX_FAKE_FDS; i++) {
+    if (fakeFds[i].kind == FD_FREE) {
+      memset(&fakeFds[i], 0, sizeof(fakeFds[i]));
+      fakeFds[i].fd = fd;
+      fakeFds[i].kind = kind;
+      fakeFds[i].writeFd = -1;
+      return &fakeFds[i];
+    }
+  }
+  return NULL;
+}
+
+/* ======= System calls ============= */
+int fakeOpen(const char *path, int flags) {
+  fake_fd_kind_t kind;
+  if (strncmp(path, "/dev/spidev", 11) == 0)
+    kind = FD_SPI;
+  else if (strncmp(path, "/dev/gpiochip", 13) == 0)
+    kind = FD_GPIO_CHIP;
+  else
+    return ::open(path, flags);
+
+  // A real file descriptor, so the numbers aren't used by anything else
+  int fd = ::open("/dev/null", O_RDWR | O_CLOEXEC);
+  if (fd < 0)
+    return -1;
+  if (newFakeFd(fd, kind) == NULL) {
+    ::close(fd);
+    errno = EMFILE;
+    return -1;
+  }
+  return fd;
+}
+
+int fakeClose(int fd) {
+  pthread_mutex_lock(&chipMutex);
+  fake_fd_t *fake = findFakeFd(fd);
+  if (fake != NULL) {
+    if (fake->kind == FD_LINE) {
+      if (fake->isDrdy)
+        drdyWriteFd = -1;
+      ::close(fake->writeFd);
+    }
+    fake->kind = FD_FREE;
+  }
+  pthread_mutex_unlock(&chipMutex);
+  return ::close(fd);
+}
+
+// One SPI_IOC_MESSAGE: CS is low from the first transfer to the last one
+void runSpiMessage(struct spi_ioc_transfer *transfers, uint32_t nTransfers) {
+  stats.spiMessages++;
+  stats.spiTransfers += nTransfers;
+  chip.setChipSelect(true);
+  for (uint32_t i = 0; i < nTransfers; i++) {
+    const byte *tx = (const byte *) (unsigned long) transfers[i].tx_buf;
+    byte *rx = (byte *) (unsigned long) transfers[i].rx_buf;
+    uint32_t clockHz = transfers[i].speed_hz != 0 ? transfers[i].speed_hz : 1000000;
+    for (uint32_t j = 0; j < transfers[i].len; j++) {
+      byte received = chip.transfer(tx != NULL ? tx[j] : 0x00);
+      if (rx != NULL)
+        rx[j] = received;
+      // One byte takes 8 SCLK periods
+      chip.advanceNanoseconds((8000000000ULL + clockHz - 1) / clockHz);
+    }
+    stats.spiBytes += transfers[i].len;
+    chip.advanceNanoseconds((uint64_t) transfers[i].delay_usecs * 1000);
+  }
+  chip.setChipSelect(false);
+}
+
+int requestLine(struct gpio_v2_line_request *request) {
+  if (request->num_lines != 1) {
+    errno = EINVAL;
+    return -1;
+  }
+  int pipeFds[2];
+  if (pipe(pipeFds) < 0)
+    return -1;
+  fcntl(pipeFds[0], F_SETFL, O_NONBLOCK);
+  fcntl(pipeFds[1], F_SETFL, O_NONBLOCK);
+  fake_fd_t *line = newFakeFd(pipeFds[0], FD_LINE);
+  if (line == NULL) {
+    ::close(pipeFds[0]);
+    ::close(pipeFds[1]);
+    errno = EMFILE;
+    return -1;
+  }
+  line->pin = request->offsets[0];
+  line->writeFd = pipeFds[1];
+  line->isDrdy = (request->config.flags & GPIO_V2_LINE_FLAG_EDGE_FALLING) != 0;
+  if (line->isDrdy)
+    drdyWriteFd = pipeFds[1];
+  request->fd = pipeFds[0];
+  return 0;
+}
+
+int fakeIoctl(int fd, unsigned long request, void *arg) {
+  pthread_mutex_lock(&chipMutex);
+  fake_fd_t *fake = findFakeFd(fd);
+  if (fake == NULL) {
+    pthread_mutex_unlock(&chipMutex);
+    return ::ioctl(fd, request, arg);
+  }
+  catchUp();
+
+  int result = 0;
+  if (fake->kind == FD_SPI && _IOC_TYPE(request) == SPI_IOC_MAGIC && _IOC_NR(request) == 0 && _IOC_DIR(request) == _IOC_WRITE
+      && _IOC_SIZE(request) % sizeof(struct spi_ioc_transfer) == 0) {
+    runSpiMessage((struct spi_ioc_transfer *) arg, _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer));
+  } else if (fake->kind == FD_SPI && (request == SPI_IOC_WR_MODE || request == SPI_IOC_WR_BITS_PER_WORD)) {
+    // Nothing to configure
+  } else if (fake->kind == FD_GPIO_CHIP && request == GPIO_V2_GET_LINE_IOCTL) {
+    result = requestLine((struct gpio_v2_line_request *) arg);
+  } else if (fake->kind == FD_LINE && request == GPIO_V2_LINE_SET_VALUES_IOCTL) {
+    struct gpio_v2_line_values *values = (struct gpio_v2_line_values *) arg;
+    if (values->mask & 1)
+      chip.writePin(fake->pin, (values->bits & 1) ? HIGH : LOW);
+  } else {
+    errno = ENOTTY;
+    result = -1;
+  }
+  pthread_mutex_unlock(&chipMutex);
+  return result;
+}
+
+const ads_linux_syscalls_t FAKE_SYSCALLS = {fakeOpen, fakeClose, fakeIoctl};
+}
+
+namespace ads {
+namespace hal {
+namespace linuxdev {
+namespace fake {
+ADS129xChipSimulator & install() {
+  if (isInstalled)
+    return chip;
+  for (uint8_t i = 0; i < MAX_FAKE_FDS; i++)
+    fakeFds[i].kind = FD_FREE;
+  drdyWriteFd = -1;
+  chip.powerOn();
+  chip.setDrdyCallback(drdyFalling);
+  originNs = monotonicNs();
+  resetStats();
+
+  stopTicker = false;
+  pthread_create(&tickerThread, NULL, tickerMain, NULL);
+  setSyscalls(&FAKE_SYSCALLS);
+  isInstalled = true;
+  return chip;
+}
+
+void uninstall() {
+  if (!isInstalled)
+    return;
+  stopTicker = true;
+  pthread_join(tickerThread, NULL);
+  setSyscalls(NULL);
+  isInstalled = false;
+}
+
+ads_linux_fake_stats_t getStats() {
+  pthread_mutex_lock(&chipMutex);
+  ads_linux_fake_stats_t copy = stats;
+  pthread_mutex_unlock(&chipMutex);
+  return copy;
+}
+
+void resetStats() {
+  pthread_mutex_lock(&chipMutex);
+  memset(&stats, 0, sizeof(stats));
+  pthread_mutex_unlock(&chipMutex);
+}
+}
+}
+}
+}
+
+#endif /* ADS_HAL_BACKEND == ADS_HAL_LINUX */
@@ -0,0 +1,66 @@
+/*
+    Fake spidev and GPIO character devices for the Linux backend of the hardware abstraction layer (see ads129xHalLinux.h).
+    They are connected to the ADS chip simulator (see extras/simulator/ads129xChipSimulator.h), so a program of the Linux
+    backend runs on any Linux computer without the devices: the reader thread, the SPI_IOC_MESSAGE batching and the
+    GPIO edge events are the same code that runs on the gateway.
+
+      - open() of a /dev/spidev* or /dev/gpiochip* path gives a fake device. Other paths are opened normally.
+      - SPI_IOC_MESSAGE: CS is low during the whole message. Every byte goes to the simulator and takes 8 SCLK periods
+        of the simulator time, and delay_usecs is added after its transfer.
+      - GPIO lines: the lines written with GPIO_V2_LINE_SET_VALUES_IOCTL are the pins of the simulator (connect them
+        with ADS129xChipSimulator::connectPins()). The line requested with GPIO_V2_LINE_FLAG_EDGE_FALLING is DRDY: its
+        file descriptor is the read end of a pipe and each falling DRDY of the simulator writes one gpio_v2_line_event.
+      - Time: the simulator follows CLOCK_MONOTONIC (a ticker thread advances it every _ADS_LINUX_FAKE_TICK_US
+        microseconds and every system call catches up before it's executed), so DRDY falls at the data rate in real time.
+        If the ticker thread isn't scheduled for longer than a DRDY period (a loaded computer), the simulator loses
+        conversions like a real chip whose DRDY isn't serviced, and they are gaps of sampleIndex.
+    Only one chip is simulated (ADS_MAX_SENSORS = 1).
+
+    Example:
+        ADS129xChipSimulator &chip = ads::hal::linuxdev::fake::install();
+        chip.connectPins(24);
+        ads::hal::linuxdev::setGpioChip("/dev/gpiochip0");
+        ads::hal::linuxdev::addSpiDevice(8, "/dev/spidev0.0");
+        ... // The same code than with the real devices
+        ads::hal::linuxdev::close();
+        ads::hal::linuxdev::fake::uninstall();
+
+    Building: add -Iextras/simulator, extras/linux/ads129xLinuxFake.cpp and extras/simulator/ads129xChipSimulator.cpp to
+    the build line of ads129xHalLinux.h.
+    ads129xLinuxFakeTest.cpp is a test of the backend with the fake (run it with extras/linux/runLinuxFakeTest.sh).
+*/
+#ifndef _ADS129X_LINUX_FAKE_H_
+#define _ADS129X_LINUX_FAKE_H_
+
+#include "ads129xHalLinux.h"
+#include "ads129xChipSimulator.h"
+
+#define _ADS_LINUX_FAKE_TICK_US 50 // Period of the ticker thread that advances the simulator
+
+// System calls received by the fake SPI device since install() or resetStats()
+typedef struct {
+  uint32_t spiMessages; // SPI_IOC_MESSAGE ioctls
+  uint32_t spiTransfers; // spi_ioc_transfer of all the messages
+  uint32_t spiBytes;
+} ads_linux_fake_stats_t;
+
+namespace ads {
+namespace hal {
+namespace linuxdev {
+namespace fake {
+
+// Power-on the simulator, start its ticker thread and replace the system calls of the backend (see setSyscalls()).
+// Call it before setGpioChip() and addSpiDevice(). Return the simulator
+ADS129xChipSimulator & install();
+// Stop the ticker thread and give back the system calls of the C library. Call it after ads::hal::linuxdev::close()
+void uninstall();
+
+ads_linux_fake_stats_t getStats();
+void resetStats();
+
+} // End of the fake namespace
+} // End of the linuxdev namespace
+} // End of the hal namespace
+} // End of the ads namespace
+
+#endif /* _ADS129X_LINUX_FAKE_H_ */
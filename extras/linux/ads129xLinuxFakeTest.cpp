@@ -0,0 +1,171 @@
+/*
+    Test of the Linux backend (see ads129xHalLinux.h) against the fake spidev/GPIO devices (see ads129xLinuxFake.h). It
+    runs the same code than a gateway: the reader thread, the SPI_IOC_MESSAGE batching and the GPIO edge events.
+      - The ID register is the one of ADS_CHIP_USED.
+      - A configuration with several WREG bursts and CONFIG1 is written with one SPI_IOC_MESSAGE.
+      - A transaction with more spiWrite() transfers and bytes than the queue has (MAX_QUEUED_TRANSFERS and
+        MAX_QUEUED_BYTES) writes every register right.
+      - STREAM_FRAMES frames in RDATAC mode: every status word is valid, the sample indexes only grow and every missing
+        sample index is a lost frame counted by the driver (see getFrameCounters()). The fake loses conversions when its
+        ticker thread isn't scheduled (see ads129xLinuxFake.h), so some gaps are allowed (MAX_LOST_FRAMES).
+
+    The result of each check is printed in stdout and the exit status is 0 only if all of them pass.
+
+    Building (from the root of the library):
+        g++ -std=c++11 -O2 -I. -Iextras/linux -Iextras/simulator -DADS_HAL_BACKEND=ADS_HAL_LINUX \
+            extras/linux/ads129xLinuxFakeTest.cpp extras/linux/ads129xLinuxFake.cpp extras/linux/ads129xHalLinux.cpp \
+            extras/simulator/ads129xChipSimulator.cpp ads129xDriver.cpp ads129xWritePlan.cpp ads129xDecoder.cpp \
+            ads129xHalArduino.cpp -pthread -o ads129xLinuxFakeTest
+    extras/linux/runLinuxFakeTest.sh builds and runs it for the six ADS models.
+*/
+#include "ads129xLinuxFake.h"
+#include "ads129xDecoder.h"
+
+#include <stdio.h>
+
+namespace {
+
+const uint8_t CS_PIN = 8;
+const uint8_t DRDY_PIN = 25;
+const uint8_t RESET_PIN = 24;
+
+const uint32_t STREAM_FRAMES = 1000; // 2 seconds at 500 SPS
+const uint32_t MAX_LOST_FRAMES = STREAM_FRAMES / 20;
+
+uint8_t nFailures = 0;
+
+void check(boolean passed, const char *what) {
+  printf("%s: %s\n", passed ? "PASS" : "FAIL", what);
+  if (!passed)
+    nFailures++;
+}
+
+// Frames read in RDATAC mode
+struct stream_t {
+  uint32_t nFrames;
+  uint32_t firstSampleIndex, lastSampleIndex;
+  uint32_t missingSamples; // Sample indexes skipped between two frames
+  uint32_t invalidStatusWords, samplesOutOfOrder;
+};
+
+void addFrames(const ads_frame_span_t &span, stream_t &stream) {
+  for (uint16_t i = 0; i < span.nFrames; i++) {
+    uint32_t sampleIndex = span.info[i].sampleIndex;
+    if (!ads::isStatusWordValid(span.frames[i].formatedData.statusWord))
+      stream.invalidStatusWords++;
+    if (stream.nFrames == 0)
+      stream.firstSampleIndex = sampleIndex;
+    else if (sampleIndex <= stream.lastSampleIndex)
+      stream.samplesOutOfOrder++;
+    else
+      stream.missingSamples += sampleIndex - stream.lastSampleIndex - 1;
+    stream.lastSampleIndex = sampleIndex;
+    stream.nFrames++;
+  }
+}
+
+void drain(ADS129xSensor &sensor, stream_t &stream) {
+  ads_frame_span_t span;
+  while (sensor.acquireFrames(&span)) {
+    addFrames(span, stream);
+    sensor.releaseFrames(&span);
+  }
+}
+
+}
+
+int main() {
+  using namespace ads::registers;
+
+  ADS129xChipSimulator &chip = ads::hal::linuxdev::fake::install();
+  chip.connectPins(RESET_PIN);
+  if (!ads::hal::linuxdev::setGpioChip("/dev/gpiochip0") || !ads::hal::linuxdev::addSpiDevice(CS_PIN, "/dev/spidev0.0")) {
+    puts("FAIL: the fake devices can't be opened");
+    return 1;
+  }
+
+  ADS129xSensor sensor(CS_PIN, DRDY_PIN, RESET_PIN);
+  sensor.begin();
+  check(sensor.readRegister(id::REG_ADDR) == ads::chip_traits<ADS_CHIP_USED>::ID, "ID register");
+
+  // Channels 1 and 2 (one burst), CONFIG2 (another one) and CONFIG1 (the last one)
+  ads::hal::linuxdev::fake::resetStats();
+  sensor.beginRegisterChanges();
+  sensor.enableChannelAndSetGain(1, chnSet::GAIN_1X, chnSet::TEST_SIGNAL);
+  sensor.enableChannelAndSetGain(2, chnSet::GAIN_2X, chnSet::TEST_SIGNAL);
+  sensor.setRegisterShadow(config2::REG_ADDR, config2::TEST_FREQ_4HZ);
+  sensor.setRegisterShadow(config1::REG_ADDR, config1::HIGH_RES_500_SPS);
+  sensor.endRegisterChanges();
+  ads_linux_fake_stats_t stats = ads::hal::linuxdev::fake::getStats();
+  check(stats.spiMessages == 1, "register changes in one SPI_IOC_MESSAGE");
+  check(chip.getRegister(config1::REG_ADDR) == config1::HIGH_RES_500_SPS && chip.getRegister(config2::REG_ADDR) ==
+        config2::TEST_FREQ_4HZ && chip.getRegister(chnSet::_BASE_REG_ADDR + 1) == (chnSet::GAIN_1X | chnSet::TEST_SIGNAL),
+        "registers written in the chip");
+
+  // Transactions of several spiWrite() with delays between them (each one is a queued transfer): first short transfers
+  // (WREG byte by byte) and then longer ones (WREG of CH1SET to CH4SET), so the bytes copied after a flush of the queue
+  // would reach the transfer that is queued after it if it wasn't copied after the flush. The last values stay
+  const uint8_t ROUNDS = 20;
+  ads::hal::spiBeginTransaction(CS_PIN, _ADS_SPI_MAX_SPEED);
+  for (uint8_t ch = 1; ch <= 4; ch++) {
+    byte command[3] = {(byte) (ads::commands::WREG | (chnSet::_BASE_REG_ADDR + ch)), 0x00, chnSet::SHORTED};
+    for (uint8_t i = 0; i < sizeof(command); i++) {
+      ads::hal::spiWrite(&command[i], 1);
+      ads::hal::delayUs(2);
+    }
+  }
+  for (uint8_t round = 0; round < ROUNDS; round++) {
+    byte command[2] = {(byte) (ads::commands::WREG | (chnSet::_BASE_REG_ADDR + 1)), 3}; // 4 registers
+    byte values[4];
+    for (uint8_t ch = 1; ch <= 4; ch++)
+      values[ch - 1] = (round + ch) & 0x07; // MUX bits
+    ads::hal::spiWrite(command, sizeof(command));
+    ads::hal::delayUs(2);
+    ads::hal::spiWrite(values, sizeof(values));
+    ads::hal::delayUs(2);
+  }
+  ads::hal::spiEndTransaction(CS_PIN);
+  boolean areWritesRight = true;
+  for (uint8_t ch = 1; ch <= 4; ch++)
+    areWritesRight = areWritesRight && chip.getRegister(chnSet::_BASE_REG_ADDR + ch) == ((ROUNDS - 1 + ch) & 0x07);
+  check(areWritesRight, "more queued writes than the queue has");
+  // The register shadow of the sensor didn't see these writes -> the chip gets its values back
+  for (uint8_t ch = 1; ch <= 4; ch++)
+    chip.setRegister(chnSet::_BASE_REG_ADDR + ch, sensor.getRegisterShadow(chnSet::_BASE_REG_ADDR + ch));
+
+  // The first DRDY edge comes some periods after START (settling of the digital filter), so RDATAC mode is entered
+  // before it: every DRDY edge after START is stored or counted as lost
+  ads_frame_counters_t before, after;
+  sensor.getFrameCounters(&before);
+  sensor.sendSPICommandSTART();
+  sensor.sendSPICommandRDATAC();
+
+  stream_t stream = {};
+  uint32_t timeouts = 0;
+  while (stream.nFrames < STREAM_FRAMES && timeouts < 10) {
+    if (!ads::hal::linuxdev::waitForInterrupt(100))
+      timeouts++;
+    drain(sensor, stream);
+  }
+  // The DRDY edges after SDATAC aren't read
+  sensor.sendSPICommandSDATAC();
+  drain(sensor, stream);
+  sensor.getFrameCounters(&after);
+
+  uint32_t lostFrames = (after.framesDropped - before.framesDropped) + (after.edgesWhileSpiOpen - before.edgesWhileSpiOpen);
+  printf("frames %u, sample indexes %u..%u, missing %u, lost (counters) %u, DRDY timeouts %u\n", stream.nFrames,
+         stream.firstSampleIndex, stream.lastSampleIndex, stream.missingSamples, lostFrames, timeouts);
+  check(stream.nFrames >= STREAM_FRAMES, "frames received");
+  check(stream.nFrames == after.framesStored - before.framesStored, "frames received are the frames stored");
+  check(stream.firstSampleIndex == before.drdyEdges, "first frame is the first DRDY edge after START");
+  check(stream.invalidStatusWords == 0, "status words");
+  check(stream.samplesOutOfOrder == 0, "sample indexes only grow");
+  check(stream.missingSamples == lostFrames, "every missing sample index is a lost frame");
+  check(stream.missingSamples <= MAX_LOST_FRAMES, "lost frames");
+
+  sensor.end();
+  ads::hal::linuxdev::close();
+  ads::hal::linuxdev::fake::uninstall();
+  printf("%s\n", nFailures == 0 ? "All checks passed" : "Some checks failed");
+  return nFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Build and run ads129xLinuxFakeTest.cpp for the six ADS models. The checks are printed in stdout and the exit status is
+# not 0 if any of them fails. Run it from any directory:
+#     extras/linux/runLinuxFakeTest.sh
+# CXX and CXXFLAGS can be set to test other compilers and options (default: g++ and -O2).
+set -e
+
+LIBRARY_DIR=$(cd "$(dirname "$0")/../.." && pwd)
+BUILD_DIR=$(mktemp -d)
+trap 'rm -rf "$BUILD_DIR"' EXIT
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2}
+
+FAILED=""
+for CHIP in ADS_1294 ADS_1294R ADS_1296 ADS_1296R ADS_1298 ADS_1298R; do
+  PROGRAM="$BUILD_DIR/linuxFakeTest_${CHIP}"
+  $CXX -std=c++11 $CXXFLAGS -I"$LIBRARY_DIR" -I"$LIBRARY_DIR/extras/linux" -I"$LIBRARY_DIR/extras/simulator" \
+    -DADS_HAL_BACKEND=ADS_HAL_LINUX -DADS_CHIP_USED=$CHIP "$LIBRARY_DIR/extras/linux/ads129xLinuxFakeTest.cpp" \
+    "$LIBRARY_DIR/extras/linux/ads129xLinuxFake.cpp" "$LIBRARY_DIR/extras/linux/ads129xHalLinux.cpp" \
+    "$LIBRARY_DIR/extras/simulator/ads129xChipSimulator.cpp" "$LIBRARY_DIR/ads129xDriver.cpp" "$LIBRARY_DIR/ads129xWritePlan.cpp" \
+    "$LIBRARY_DIR/ads129xDecoder.cpp" "$LIBRARY_DIR/ads129xHalArduino.cpp" -pthread -o "$PROGRAM"
+  echo "== $CHIP"
+  "$PROGRAM" 2> /dev/null || FAILED="$FAILED $CHIP"
+done
+
+if [ -n "$FAILED" ]; then
+  echo "Failed:$FAILED"
+  exit 1
+fi
@@ -0,0 +1,57 @@
+#include "ads129xRecordingFile.h"
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ads {
+namespace recording {
+boolean writeToFile(void *file, const void *data, uint32_t nBytes) {
+  return fwrite(data, 1, nBytes, (FILE *) file) == nBytes;
+}
+} // End of the recording namespace
+} // End of the ads namespace
+
+
+boolean ADS129xRecordingFile::open(const char *path) {
+  close();
+
+  fd = ::open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+    close();
+    return false;
+  }
+  size = fileStat.st_size;
+
+  mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    mapping = NULL;
+    close();
+    return false;
+  }
+  // Chunks are usually read from the first to the last one
+  madvise(mapping, size, MADV_SEQUENTIAL);
+
+  if (!reader.open(mapping, size)) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void ADS129xRecordingFile::close() {
+  reader = ADS129xRecordingReader();
+  if (mapping != NULL)
+    munmap(mapping, size);
+  if (fd >= 0)
+    ::close(fd);
+  fd = -1;
+  mapping = NULL;
+  size = 0;
+}
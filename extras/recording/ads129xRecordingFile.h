@@ -0,0 +1,65 @@
+/*
+    Host-side helpers (POSIX systems: Linux, macOS, ...) to write recordings in files and to read them without loading
+    them in memory (see ads129xRecording.h for the format).
+
+    The file is mapped in memory (mmap), so opening a recording of tens of GB is immediate and only the pages of the
+    chunks that are read are loaded by the operating system. Example:
+
+        ADS129xRecordingFile file;
+        if (file.open("ecg.ads")) {
+          ADS129xRecordingReader &reader = file.getReader();
+          for (uint32_t i = 0; i < reader.getChunkCount(); i++) {
+            const ads_data_t *frames = reader.getFrames<ads_frame_traits_t>(i);
+            ... // reader.getChunk(i)->nFrames frames
+          }
+        }
+
+    Writing (ads::recording::writeToFile() is an ads_recording_output_t that writes in a FILE *):
+
+        FILE *out = fopen("ecg.ads", "wb");
+        ads_data_t chunkFrames[256];
+        ADS129xRecordingWriter writer(chunkFrames, 256, ads::recording::writeToFile, out);
+
+    Building: add ads129xRecording.cpp and extras/recording/ads129xRecordingFile.cpp to the build, and -Iextras/recording
+*/
+#ifndef _ADS129X_RECORDING_FILE_H_
+#define _ADS129X_RECORDING_FILE_H_
+
+#include "ads129xRecording.h"
+
+namespace ads {
+namespace recording {
+// ads_recording_output_t that writes in the FILE * given as context
+boolean writeToFile(void *file, const void *data, uint32_t nBytes);
+} // End of the recording namespace
+} // End of the ads namespace
+
+/* ======= ADS129xRecordingFile class definition  ============= */
+// Recording file mapped in memory (read-only)
+class ADS129xRecordingFile {
+  private:
+    int fd;
+    void *mapping;
+    uint64_t size;
+    ADS129xRecordingReader reader;
+
+  public:
+    ADS129xRecordingFile() {
+      fd = -1;
+      mapping = NULL;
+      size = 0;
+    }
+    ~ADS129xRecordingFile() {
+      close();
+    }
+
+    // Map the file and check its header. Return false if the file can't be mapped or it isn't a valid recording
+    boolean open(const char *path);
+    void close();
+    // Reader of the mapped file. Its pointers are valid until close() is called
+    ADS129xRecordingReader & getReader() {
+      return reader;
+    }
+};
+
+#endif /* _ADS129X_RECORDING_FILE_H_ */
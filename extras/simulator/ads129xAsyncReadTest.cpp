@@ -0,0 +1,123 @@
+/*
+    Test of the asynchronous frame read (ADS_ASYNC_FRAME_READ, see ads129xDriverConfig.h) with the host backend, whose
+    DMA channel is a thread (see ads129xChipSimulator.h).
+      - STREAM_MS delays of 1 ms at 8 kSPS, draining the ring buffer after each one: the time of the program is only
+        the one of its delays (the bytes of the DMA channel don't add time), every DRDY edge is stored except the one
+        whose frame is still being read at the end, there aren't gaps in the sample indexes nor lost frames and every
+        status word is valid.
+      - SDATAC is sent while a frame is being read: hal::spiBeginTransaction() waits until the frame is read (the frame
+        is stored) and the chip leaves RDATAC mode.
+
+    The ring buffer must have room for the frames of one delay (8) plus the one being read: build it with
+    -DADS_FRAME_BUFFER_SIZE=16. The result of each check is printed in stdout and the exit status is 0 only if all of
+    them pass.
+
+    Building (from the root of the library):
+        g++ -std=c++11 -O2 -I. -Iextras/simulator -DADS_ASYNC_FRAME_READ=1 -DADS_FRAME_BUFFER_SIZE=16 \
+            extras/simulator/ads129xAsyncReadTest.cpp extras/simulator/ads129xChipSimulator.cpp extras/simulator/ads129xHalHost.cpp \
+            ads129xDriver.cpp ads129xWritePlan.cpp ads129xDecoder.cpp ads129xHalArduino.cpp -pthread -o ads129xAsyncReadTest
+    extras/simulator/runAsyncReadTest.sh builds and runs it for the six ADS models.
+*/
+#include "ads129xChipSimulator.h"
+
+#include <stdio.h>
+
+#if !ADS_ASYNC_FRAME_READ || ADS_FRAME_BUFFER_SIZE < 16
+#error "Build the test with -DADS_ASYNC_FRAME_READ=1 -DADS_FRAME_BUFFER_SIZE=16"
+#endif
+
+namespace {
+
+const uint8_t CS_PIN = 10;
+const uint8_t DRDY_PIN = 2;
+const uint8_t RESET_PIN = 9;
+
+const uint16_t STREAM_MS = 1000; // 8000 frames at 8 kSPS
+const uint32_t MAX_WAIT_US = 1000; // A DRDY edge comes every 125 us at 8 kSPS
+
+uint8_t nFailures = 0;
+
+void check(boolean passed, const char *what) {
+  printf("%s: %s\n", passed ? "PASS" : "FAIL", what);
+  if (!passed)
+    nFailures++;
+}
+
+// Frames read in RDATAC mode
+struct stream_t {
+  uint32_t nFrames;
+  uint32_t lastSampleIndex;
+  uint32_t missingSamples; // Sample indexes skipped between two frames
+  uint32_t invalidStatusWords, samplesOutOfOrder;
+};
+
+void drain(ADS129xSensor &sensor, stream_t &stream) {
+  ads_frame_span_t span;
+  while (sensor.acquireFrames(&span)) {
+    for (uint16_t i = 0; i < span.nFrames; i++) {
+      uint32_t sampleIndex = span.info[i].sampleIndex;
+      if (!ads::isStatusWordValid(span.frames[i].formatedData.statusWord))
+        stream.invalidStatusWords++;
+      if (stream.nFrames > 0 && sampleIndex <= stream.lastSampleIndex)
+        stream.samplesOutOfOrder++;
+      else if (stream.nFrames > 0)
+        stream.missingSamples += sampleIndex - stream.lastSampleIndex - 1;
+      stream.lastSampleIndex = sampleIndex;
+      stream.nFrames++;
+    }
+    sensor.releaseFrames(&span);
+  }
+}
+
+}
+
+int main() {
+  using namespace ads::registers;
+
+  ADS129xChipSimulator &chip = ads::hal::host::simulator();
+  chip.connectPins(RESET_PIN);
+
+  ADS129xSensor sensor(CS_PIN, DRDY_PIN, RESET_PIN);
+  sensor.begin();
+  sensor.writeRegister(config1::REG_ADDR, config1::HIGH_RES_8k_SPS);
+
+  ads_frame_counters_t before, after;
+  sensor.getFrameCounters(&before);
+  sensor.sendSPICommandSTART();
+  sensor.sendSPICommandRDATAC();
+
+  stream_t stream = {};
+  uint32_t startUs = ads::hal::micros();
+  for (uint16_t i = 0; i < STREAM_MS; i++) {
+    ads::hal::delayMs(1);
+    drain(sensor, stream);
+  }
+  uint32_t elapsedUs = ads::hal::micros() - startUs;
+  sensor.getFrameCounters(&after);
+
+  uint32_t drdyEdges = after.drdyEdges - before.drdyEdges;
+  uint32_t lostFrames = (after.framesDropped - before.framesDropped) + (after.edgesWhileSpiOpen - before.edgesWhileSpiOpen);
+  printf("elapsed %u us, frames %u, DRDY edges %u, missing %u, lost (counters) %u\n", elapsedUs, stream.nFrames,
+         drdyEdges, stream.missingSamples, lostFrames);
+  check(elapsedUs == STREAM_MS * 1000UL, "the DMA channel doesn't add time to the program");
+  check(stream.nFrames + 1 >= drdyEdges, "frames received");
+  check(stream.missingSamples == 0, "no gaps in the sample indexes");
+  check(stream.samplesOutOfOrder == 0, "sample indexes only grow");
+  check(lostFrames == 0, "no lost frames");
+  check(stream.invalidStatusWords == 0, "status words");
+
+  // A new sample index means a new DRDY edge: its interruption has just started the transfer of the frame
+  uint32_t sampleIndex = chip.getSampleIndex();
+  for (uint32_t waitedUs = 0; chip.getSampleIndex() == sampleIndex && waitedUs < MAX_WAIT_US; waitedUs++)
+    ads::hal::delayUs(1);
+  sensor.getFrameCounters(&before);
+  check(before.framesStored + 1 == before.drdyEdges, "a frame is being read");
+  sensor.sendSPICommandSDATAC();
+  sensor.getFrameCounters(&after);
+  check(after.framesStored == before.drdyEdges, "SDATAC waits until the frame is read");
+  check(!chip.isInRdatacMode(), "SDATAC sent after the frame");
+
+  sensor.end();
+  printf("%s\n", nFailures == 0 ? "All checks passed" : "Some checks failed");
+  return nFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,385 @@
+#include "ads129xChipSimulator.h"
+
+#include <math.h>
+
+using namespace ads;
+
+#define _ADS_SIM_CMD_OPCODE 0 // Waiting for a new opcode
+#define _ADS_SIM_CMD_N_REGISTERS 1 // Waiting for the second opcode of RREG/WREG (number of registers - 1)
+#define _ADS_SIM_CMD_REGISTER_DATA 2 // Reading/writing registers
+
+static double defaultElectrodeSignal(uint8_t channel, double timeSeconds) {
+  // 10 Hz sine of 1 mV. Each channel has a different phase to distinguish them
+  return 1e-3 * sin(2 * M_PI * 10 * timeSeconds + channel * M_PI / 4);
+}
+
+ADS129xChipSimulator::ADS129xChipSimulator() {
+  chipId = ads::chip_traits<ADS_CHIP_USED>::ID;
+  nChannels = ads::chip_traits<ADS_CHIP_USED>::N_CHANNELS;
+  chipSelectPin = ADS_PIN_NOT_USED;
+  drdyPin = ADS_PIN_NOT_USED;
+  resetPin = ADS_PIN_NOT_USED;
+  startPin = ADS_PIN_NOT_USED;
+  pwdnPin = ADS_PIN_NOT_USED;
+  electrodeSignal = defaultElectrodeSignal;
+  drdyCallback = NULL;
+  powerOn();
+}
+
+void ADS129xChipSimulator::powerOn() {
+  nowNs = 0;
+  processingEvents = false;
+  startPinLevel = false;
+  poweredDown = false;
+  chipSelected = false;
+  sampleIndex = 0;
+  drdyLow = false;
+  resetRegisters();
+}
+
+boolean ADS129xChipSimulator::setChipModel(uint8_t chip) {
+  switch (chip) {
+#define _ADS_SIM_CHIP_MODEL(model) \
+    case model: \
+      chipId = ads::chip_traits<model>::ID; \
+      nChannels = ads::chip_traits<model>::N_CHANNELS; \
+      break;
+    _ADS_SIM_CHIP_MODEL(ADS_1294)
+    _ADS_SIM_CHIP_MODEL(ADS_1294R)
+    _ADS_SIM_CHIP_MODEL(ADS_1296)
+    _ADS_SIM_CHIP_MODEL(ADS_1296R)
+    _ADS_SIM_CHIP_MODEL(ADS_1298)
+    _ADS_SIM_CHIP_MODEL(ADS_1298R)
+#undef _ADS_SIM_CHIP_MODEL
+    default:
+      return false;
+  }
+  resetRegisters();
+  return true;
+}
+
+void ADS129xChipSimulator::resetRegisters() {
+  using namespace ads::registers;
+
+  for (uint8_t i = 0; i < N_REGISTERS; i++)
+    registers[i] = 0x00;
+
+  registers[id::REG_ADDR] = chipId;
+  registers[config1::REG_ADDR] = config1::RESET_VALUE;
+  registers[config2::REG_ADDR] = config2::RESET_VALUE;
+  registers[config3::REG_ADDR] = config3::RESET_VALUE;
+  registers[loff::REG_ADDR] = loff::RESET_VALUE;
+  for (uint8_t i = 1; i <= 8; i++)
+    registers[chnSet::_BASE_REG_ADDR + i] = chnSet::RESET_VALUE;
+  registers[rldSensp::REG_ADDR] = rldSensp::RESET_VALUE;
+  registers[rldSensn::REG_ADDR] = rldSensn::RESET_VALUE;
+  registers[loffSensp::REG_ADDR] = loffSensp::RESET_VALUE;
+  registers[loffSensn::REG_ADDR] = loffSensn::RESET_VALUE;
+  registers[loffFlip::REG_ADDR] = loffFlip::RESET_VALUE;
+  registers[gpio::REG_ADDR] = gpio::RESET_VALUE;
+  registers[pace::REG_ADDR] = pace::RESET_VALUE;
+  registers[resp::REG_ADDR] = resp::RESET_VALUE;
+  registers[config4::REG_ADDR] = config4::RESET_VALUE;
+  registers[wct1::REG_ADDR] = wct1::RESET_VALUE;
+  registers[wct2::REG_ADDR] = wct2::RESET_VALUE;
+
+  // The device enters in RDATAC mode after a reset. See page 62, section 9.5.2.6 RDATAC: Read Data Continuous, in the datasheet
+  rdatacMode = true;
+  startCommandReceived = false;
+  standby = false;
+  commandState = _ADS_SIM_CMD_OPCODE;
+  shiftingFrame = false;
+  framePointer = 0;
+  frameSize = 0;
+  converting = false;
+  updateConversionState();
+}
+
+void ADS129xChipSimulator::connectPins(uint8_t resetPin, uint8_t startPin, uint8_t pwdnPin) {
+  this->resetPin = resetPin;
+  this->startPin = startPin;
+  this->pwdnPin = pwdnPin;
+}
+
+void ADS129xChipSimulator::connectBusPins(uint8_t chipSelectPin, uint8_t drdyPin) {
+  this->chipSelectPin = chipSelectPin;
+  this->drdyPin = drdyPin;
+}
+
+void ADS129xChipSimulator::setDrdyCallback(ads_sim_drdy_callback_t callback) {
+  drdyCallback = callback;
+}
+
+void ADS129xChipSimulator::setElectrodeSignal(ads_sim_signal_t signal) {
+  electrodeSignal = signal != NULL ? signal : defaultElectrodeSignal;
+}
+
+/* ====== Time and conversions ========== */
+uint64_t ADS129xChipSimulator::getClockCycles() const {
+  // fCLK / 1e9 = 2048000 / 1e9 = 256 / 125000
+  return nowNs * 256 / 125000;
+}
+
+static uint64_t cyclesToNs(uint64_t cycles) {
+  return (cycles * 125000 + 255) / 256;
+}
+
+uint64_t ADS129xChipSimulator::conversionPeriodCycles() const {
+  using namespace ads::registers::config1;
+  uint8_t dr = registers[REG_ADDR] & (B_DR2 | B_DR1 | B_DR0);
+  if (dr > 6)
+    dr = 6; // DR = 111 is reserved ("do not use")
+  // High resolution: fMOD = fCLK/4, low power: fMOD = fCLK/8. Data rate is fMOD/16 for DR = 000 and it halves for each DR step.
+  // See page 66, section 9.6.1.2 CONFIG1, in the datasheet
+  uint64_t baseCycles = (registers[REG_ADDR] & B_HR) ? 64 : 128;
+  return baseCycles << dr;
+}
+
+uint32_t ADS129xChipSimulator::getDataRate() const {
+  return _ADS_SIM_CLK_HZ / conversionPeriodCycles();
+}
+
+void ADS129xChipSimulator::updateConversionState() {
+  boolean wasConverting = converting;
+  converting = (startPinLevel || startCommandReceived) && !poweredDown && !standby;
+  if (converting && !wasConverting)
+    restartConversions();
+  if (!converting)
+    drdyLow = false;
+}
+
+void ADS129xChipSimulator::restartConversions() {
+  nextConversionCycle = getClockCycles() + _ADS_SIM_SETTLING_PERIODS * conversionPeriodCycles();
+}
+
+void ADS129xChipSimulator::advanceNanoseconds(uint64_t ns) {
+  // Called from the DRDY callback (SPI bytes of the interruption). The conversions are processed by the outer call
+  if (processingEvents) {
+    nowNs += ns;
+    return;
+  }
+
+  uint64_t targetNs = nowNs + ns;
+  processingEvents = true;
+  while (converting && cyclesToNs(nextConversionCycle) <= targetNs) {
+    uint64_t conversionNs = cyclesToNs(nextConversionCycle);
+    if (conversionNs > nowNs)
+      nowNs = conversionNs;
+
+    // The DRDY callback can take longer than a conversion period. Conversions finished meanwhile are
+    // overwritten by the last one and only one DRDY is delivered.
+    uint64_t period = conversionPeriodCycles();
+    uint64_t nMissed = (getClockCycles() - nextConversionCycle) / period;
+    sampleIndex += nMissed;
+    nextConversionCycle += nMissed * period;
+
+    latchNewFrame(nextConversionCycle);
+    nextConversionCycle += period;
+    if (drdyCallback != NULL)
+      drdyCallback(this);
+  }
+  if (nowNs < targetNs)
+    nowNs = targetNs;
+  processingEvents = false;
+}
+
+int32_t ADS129xChipSimulator::channelCode(uint8_t device, uint8_t channel, double timeSeconds) const {
+  using namespace ads::registers;
+
+  byte chSet = registers[chnSet::_BASE_REG_ADDR + 1 + channel];
+  if (chSet & chnSet::B_PDn)
+    return 0;
+
+  double vref = (registers[config3::REG_ADDR] & config3::B_VREF_4V) ? 4.0 : 2.4;
+  double volts = 0;
+  switch (chSet & (chnSet::B_MUXn2 | chnSet::B_MUXn1 | chnSet::B_MUXn0)) {
+    case chnSet::ELECTRODE_INPUT:
+      volts = electrodeSignal(device * nChannels + channel, timeSeconds);
+      break;
+    case chnSet::TEST_SIGNAL: {
+      byte cfg2 = registers[config2::REG_ADDR];
+      if (!(cfg2 & config2::B_INT_TEST))
+        break; // External test signal -> not modelled
+      double amplitude = ((cfg2 & config2::B_TEST_AMP) ? 2 : 1) * vref / 2400;
+      // TEST_FREQ = 00 -> fCLK/2^21, 01 -> fCLK/2^20, 11 -> DC. See page 68, section 9.6.1.3 CONFIG2, in the datasheet
+      uint8_t testFreq = cfg2 & 0x03;
+      if (testFreq == 0x03) {
+        volts = amplitude;
+      } else {
+        uint64_t halfPeriodCycles = (testFreq == 0x00 ? (1ULL << 21) : (1ULL << 20)) / 2;
+        uint64_t cycles = (uint64_t)(timeSeconds * _ADS_SIM_CLK_HZ);
+        volts = ((cycles / halfPeriodCycles) & 1) ? -amplitude : amplitude;
+      }
+      break;
+    }
+    default:
+      volts = 0; // Shorted, RLD, MVDD, temperature... are not modelled
+  }
+
+  static const uint8_t gains[8] = {6, 1, 2, 3, 4, 8, 12, 6};
+  uint8_t gain = gains[(chSet >> 4) & 0x07];
+  double code = round(volts * gain / vref * 8388607.0);
+  if (code > 8388607.0)
+    code = 8388607.0;
+  if (code < -8388608.0)
+    code = -8388608.0;
+  return (int32_t) code;
+}
+
+void ADS129xChipSimulator::latchNewFrame(uint64_t conversionCycle) {
+  using namespace ads::registers;
+
+  double timeSeconds = (double) conversionCycle / _ADS_SIM_CLK_HZ;
+  byte statp = registers[loffStatp::REG_ADDR];
+  byte statn = registers[loffStatn::REG_ADDR];
+  byte gpioData = registers[gpio::REG_ADDR] >> 4;
+
+  // 16 bits per channel only for DR = 000. See page 53, section 9.4.1.3.2 Readback length, in the datasheet
+  boolean is16Bits = (registers[config1::REG_ADDR] & (config1::B_DR2 | config1::B_DR1 | config1::B_DR0)) == 0;
+  uint8_t pos = 0;
+  // Daisy-chained devices share the commands, so all of them have the same registers. The data of the
+  // first device is shifted out first. See page 57, figure 9-24 Daisy-Chain Configuration Timing, in the datasheet
+  for (uint8_t device = 0; device < ADS_DAISY_CHAIN_DEVICES; device++) {
+    // Status word: 1100 + LOFF_STATP + LOFF_STATN + GPIO. See page 53, section 9.4.1.3.1 Status Word, in the datasheet
+    frame[pos++] = 0xC0 | (statp >> 4);
+    frame[pos++] = (statp << 4) | (statn >> 4);
+    frame[pos++] = (statn << 4) | gpioData;
+
+    for (uint8_t ch = 0; ch < nChannels; ch++) {
+      int32_t code = channelCode(device, ch, timeSeconds);
+      if (is16Bits) {
+        code >>= 8;
+        frame[pos++] = (code >> 8) & 0xFF;
+        frame[pos++] = code & 0xFF;
+      } else {
+        frame[pos++] = (code >> 16) & 0xFF;
+        frame[pos++] = (code >> 8) & 0xFF;
+        frame[pos++] = code & 0xFF;
+      }
+    }
+  }
+  frameSize = pos;
+  framePointer = 0;
+  sampleIndex++;
+  drdyLow = true;
+}
+
+/* ====== Pins ========== */
+void ADS129xChipSimulator::writePin(uint8_t pin, uint8_t level) {
+  if (pin == ADS_PIN_NOT_USED)
+    return;
+
+  if (pin == resetPin && level == LOW) {
+    resetRegisters();
+  } else if (pin == startPin) {
+    startPinLevel = level == HIGH;
+    updateConversionState();
+  } else if (pin == pwdnPin) {
+    boolean goingDown = level == LOW;
+    if (poweredDown && !goingDown)
+      resetRegisters(); // Exiting power-down mode resets the device. See page 48, section 9.3.2.2 Power-Down Pin (PWDN), in the datasheet
+    poweredDown = goingDown;
+    updateConversionState();
+  }
+}
+
+/* ====== SPI ========== */
+void ADS129xChipSimulator::setChipSelect(boolean selected) {
+  if (selected && !chipSelected) {
+    // A new command starts. Frame data is shifted again from the beginning
+    commandState = _ADS_SIM_CMD_OPCODE;
+    shiftingFrame = false;
+    framePointer = 0;
+  }
+  chipSelected = selected;
+}
+
+byte ADS129xChipSimulator::transfer(byte mosi) {
+  if (!chipSelected || poweredDown)
+    return 0x00;
+
+  // In RDATAC mode, data is shifted out and all commands except SDATAC are ignored
+  if (rdatacMode) {
+    drdyLow = false; // DRDY goes high on the first SCLK falling edge
+    byte miso = framePointer < frameSize ? frame[framePointer++] : 0x00;
+    if (mosi == ads::commands::SDATAC)
+      rdatacMode = false;
+    return miso;
+  }
+
+  switch (commandState) {
+    case _ADS_SIM_CMD_OPCODE:
+      // After RDATA, DIN must be low while the frame is read
+      if (shiftingFrame && mosi == 0x00) {
+        drdyLow = false;
+        return framePointer < frameSize ? frame[framePointer++] : 0x00;
+      }
+      return executeOpcode(mosi);
+
+    case _ADS_SIM_CMD_N_REGISTERS:
+      registersLeft = (mosi & 0x1F) + 1;
+      registerPointer = multiByteOpcode & 0x1F;
+      commandState = _ADS_SIM_CMD_REGISTER_DATA;
+      return 0x00;
+
+    case _ADS_SIM_CMD_REGISTER_DATA: {
+      byte miso = 0x00;
+      if ((multiByteOpcode & 0xE0) == ads::commands::RREG) {
+        if (registerPointer < registers::N_REGISTERS)
+          miso = registers[registerPointer];
+      } else {
+        writeRegisterFromSpi(registerPointer, mosi);
+      }
+      registerPointer++;
+      if (--registersLeft == 0)
+        commandState = _ADS_SIM_CMD_OPCODE;
+      return miso;
+    }
+  }
+  return 0x00;
+}
+
+byte ADS129xChipSimulator::executeOpcode(byte opcode) {
+  using namespace ads::commands;
+
+  if ((opcode & 0xE0) == RREG || (opcode & 0xE0) == WREG) {
+    multiByteOpcode = opcode;
+    commandState = _ADS_SIM_CMD_N_REGISTERS;
+    return 0x00;
+  }
+
+  switch (opcode) {
+    case WAKEUP: standby = false; updateConversionState(); break;
+    case STANDBY: standby = true; updateConversionState(); break;
+    case RESET: resetRegisters(); break;
+    case START:
+      // Restarting the conversions if they are already running. See page 62, section 9.5.2.4 START, in the datasheet
+      startCommandReceived = true;
+      if (converting)
+        restartConversions();
+      updateConversionState();
+      break;
+    case STOP: startCommandReceived = false; updateConversionState(); break;
+    case RDATAC: rdatacMode = true; break;
+    case SDATAC: rdatacMode = false; break;
+    case RDATA:
+      shiftingFrame = true;
+      framePointer = 0;
+      break;
+    default: break; // Unknown opcode -> ignored
+  }
+  return 0x00;
+}
+
+void ADS129xChipSimulator::writeRegisterFromSpi(uint8_t addr, byte value) {
+  using namespace ads::registers;
+
+  // Writes to read-only registers are ignored
+  if (addr >= N_REGISTERS || addr == id::REG_ADDR || addr == loffStatp::REG_ADDR || addr == loffStatn::REG_ADDR)
+    return;
+
+  registers[addr] = value;
+  // Writing CONFIG1 or RESP resets the digital filter. See page 48, section 9.3.2.3 Reset (RESET Pin and Reset Command), in the datasheet
+  if ((addr == config1::REG_ADDR || addr == resp::REG_ADDR) && converting)
+    restartConversions();
+}
@@ -0,0 +1,159 @@
+/*
+    Host-side model of an ADS129x chip. It is used by the host backend of the hardware abstraction layer
+    (ads129xHalHost.cpp) to compile and exercise ADS129xSensor on a computer without any board.
+
+    What is modelled:
+      - Register map of ads129xDatasheetConstants.h with its reset values, reserved bits and read-only registers.
+        ID register reports the chip model of the simulator: ADS_CHIP_USED or the one given to setChipModel().
+      - SPI commands: WAKEUP, STANDBY, RESET, START, STOP, RDATAC, SDATAC, RDATA, RREG and WREG (with the
+        multi-register form). Like the real chip, only SDATAC is accepted in RDATAC mode and the device enters
+        RDATAC mode after a reset. See page 61, section 9.5.2 SPI Command Definitions, in the datasheet.
+      - RESET, START and PWDN pins.
+      - DRDY timing. Time is counted in ADS clock cycles (t_CLK, fCLK = 2.048 MHz). The conversion period is derived
+        from the CONFIG1 data rate (HR: 64 << DR cycles, LP: 128 << DR cycles). The first DRDY after START or after
+        writing CONFIG1/RESP (internal reset of the digital filter) comes after _ADS_SIM_SETTLING_PERIODS periods.
+        If a new conversion finishes before the previous one was serviced, only one DRDY interruption is delivered
+        (like the pending flag of a real microcontroller).
+      - Frames: 24 bits of status word (1100 + LOFF_STATP + LOFF_STATN + GPIO) followed by the channels in binary
+        two's complement, MSB first. 16 bits per channel when DR = 000, 24 bits otherwise. See page 53, section
+        9.4.1.3.2 Readback length, in the datasheet.
+      - Channel inputs (CHnSET MUX bits): electrode input (user signal, a 10 Hz sine of 1 mV by default), shorted,
+        test signal (square wave of +-1 mV or +-2 mV, see CONFIG2) and the rest of inputs as 0 V. Gain and the
+        reference voltage (CONFIG3 VREF_4V) are applied. Powered-down channels output 0.
+      - Daisy-chain (ADS_DAISY_CHAIN_DEVICES > 1): a chain of devices with the same registers (commands are shared).
+        The frame has the data of all devices, first device first. The electrode signal of channel i of device d
+        is the one of channel d * (channels of the chip model) + i.
+
+    Several chips in cascade configuration (ADS_MAX_SENSORS > 1) are simulated with one simulator per chip. Each one must
+    be connected to the CS and DRDY pins given to its ADS129xSensor object (see connectBusPins()). The chips can be of
+    different models, like the ADS129xChipSensor objects that drive them (see setChipModel()).
+
+    Time only advances when the host backend asks for it: delays, SPI bytes (8 SCLK periods at the configured
+    SPI clock) and explicit advanceMicroseconds() calls from your program.
+
+    With ADS_ASYNC_FRAME_READ, the host backend emulates the DMA channel with a thread: it transfers the frame while your
+    program runs and calls the completion interruption when the time of your program (delays) reaches the end of the
+    transfer (its bytes at the SPI clock). The bytes of the DMA channel don't add time to your program, so the frame is
+    published a bit later than the DRDY interruption but no DRDY edge is delayed.
+    ads129xAsyncReadTest.cpp is a test of it (run it with extras/simulator/runAsyncReadTest.sh).
+
+    Building a host program (from the root of the library):
+        g++ -std=c++11 -I. -Iextras/simulator yourProgram.cpp ads129xDriver.cpp ads129xWritePlan.cpp ads129xDecoder.cpp ads129xRecording.cpp ads129xFilter.cpp \
+            ads129xDecimator.cpp ads129xQrsDetector.cpp ads129xProfile.cpp ads129xHalArduino.cpp extras/simulator/ads129xChipSimulator.cpp \
+            extras/simulator/ads129xHalHost.cpp -pthread -o yourProgram
+    (ads129xHalArduino.cpp is empty when the host backend is selected but it doesn't hurt to compile all the .cpp files)
+    Add -DADS_CHIP_USED=ADS_1298 (or another chip) to simulate another model, or call setChipModel() in your program.
+*/
+#ifndef _ADS129X_CHIP_SIMULATOR_H_
+#define _ADS129X_CHIP_SIMULATOR_H_
+
+#include "ads129xDriver.h"
+
+#define _ADS_SIM_CLK_HZ 2048000 // Nominal ADS clock. See page 17, section 7.6 Timing Requirements: Serial Interface, in the datasheet
+#define _ADS_SIM_SETTLING_PERIODS 4 // Conversion periods until the first DRDY after START (digital filter settling)
+#define _ADS_SIM_MAX_FRAME_SIZE (ADS_DAISY_CHAIN_DEVICES * (3 + 3 * 8)) // 8 channels: the biggest chip model
+
+class ADS129xChipSimulator;
+// Called when the DRDY pin of chip falls
+typedef void (*ads_sim_drdy_callback_t)(ADS129xChipSimulator *chip);
+
+// Voltage (in volts) at the electrode input of channel (0 is the first channel of the first device) at timeSeconds
+typedef double (*ads_sim_signal_t)(uint8_t channel, double timeSeconds);
+
+class ADS129xChipSimulator {
+  private:
+    byte registers[ads::registers::N_REGISTERS];
+    byte chipId; // ID register of the chip model
+    uint8_t nChannels; // Channels of the chip model
+    uint8_t chipSelectPin, drdyPin, resetPin, startPin, pwdnPin;
+    ads_sim_signal_t electrodeSignal;
+    ads_sim_drdy_callback_t drdyCallback;
+
+    // Time in nanoseconds and ADS clock cycles
+    uint64_t nowNs;
+    boolean processingEvents;
+
+    // Conversions
+    boolean converting, startPinLevel, startCommandReceived, poweredDown, standby;
+    uint64_t nextConversionCycle;
+    uint32_t sampleIndex;
+    boolean drdyLow;
+
+    // SPI
+    boolean chipSelected, rdatacMode;
+    uint8_t commandState; // Which byte of a command is expected
+    byte multiByteOpcode; // First opcode of RREG/WREG
+    uint8_t registerPointer, registersLeft;
+    byte frame[_ADS_SIM_MAX_FRAME_SIZE];
+    uint8_t frameSize, framePointer;
+    boolean shiftingFrame;
+
+    void resetRegisters();
+    void updateConversionState();
+    void restartConversions();
+    uint64_t conversionPeriodCycles() const;
+    void latchNewFrame(uint64_t conversionCycle);
+    int32_t channelCode(uint8_t device, uint8_t channel, double timeSeconds) const;
+    byte executeOpcode(byte opcode);
+    void writeRegisterFromSpi(uint8_t addr, byte value);
+
+  public:
+    ADS129xChipSimulator();
+
+    // Power-on the chip: registers in reset values, RDATAC mode, conversions stopped and time to zero
+    void powerOn();
+    // Simulate the chip model chip (ADS_1294, ADS_1294R, ... see ads129xDriverConfig.h) instead of ADS_CHIP_USED, for
+    // example, to drive it with an ADS129xChipSensor<ADS_1298>. The registers get their reset values (like a RESET
+    // command). Call it before begin() of the sensor. Return false (and nothing changes) if chip isn't a supported model
+    boolean setChipModel(uint8_t chip);
+    // Same pins that are given to the ADS129xSensor constructor. ADS_PIN_NOT_USED if it is not connected
+    void connectPins(uint8_t resetPin, uint8_t startPin = ADS_PIN_NOT_USED, uint8_t pwdnPin = ADS_PIN_NOT_USED);
+    // CS and DRDY pins of this chip. Only needed when several chips are simulated (see ads::hal::host::simulator())
+    void connectBusPins(uint8_t chipSelectPin, uint8_t drdyPin);
+    uint8_t getChipSelectPin() const { return chipSelectPin; }
+    uint8_t getDrdyPin() const { return drdyPin; }
+    // Called when the DRDY pin falls
+    void setDrdyCallback(ads_sim_drdy_callback_t callback);
+    // Replace the default electrode signal (10 Hz sine of 1 mV)
+    void setElectrodeSignal(ads_sim_signal_t signal);
+
+    /* ====== SPI side ========== */
+    void setChipSelect(boolean selected);
+    // One SPI byte: mosi is received by the chip and the returned value is sent by the chip
+    byte transfer(byte mosi);
+
+    /* ====== Pins ========== */
+    void writePin(uint8_t pin, uint8_t level);
+    boolean isDrdyLow() const { return drdyLow; }
+
+    /* ====== Time ========== */
+    void advanceNanoseconds(uint64_t ns);
+    void advanceMicroseconds(uint64_t us) { advanceNanoseconds(us * 1000); }
+    uint64_t getNanoseconds() const { return nowNs; }
+    uint64_t getClockCycles() const;
+
+    /* ====== Backdoor (no SPI needed) ========== */
+    byte getRegister(uint8_t addr) const { return registers[addr]; }
+    void setRegister(uint8_t addr, byte value) { registers[addr] = value; }
+    boolean isInRdatacMode() const { return rdatacMode; }
+    boolean isConverting() const { return converting; }
+    uint32_t getSampleIndex() const { return sampleIndex; }
+    // Data rate in samples per second given by CONFIG1
+    uint32_t getDataRate() const;
+};
+
+namespace ads {
+namespace hal {
+namespace host {
+// Simulators used by the host backend of the hardware abstraction layer. There is one per ADS129xSensor object that can be
+// used at the same time (ADS_MAX_SENSORS). All of them share the SPI bus and the time. The chip that answers a SPI 
+// transaction is the one connected to its CS pin (see connectBusPins()) or the first chip if none is connected to it
+ADS129xChipSimulator & simulator(uint8_t index = 0);
+// Called by the simulator when DRDY falls. The interruption attached by the driver is executed now or, if
+// a SPI transaction is open (except the one of an asynchronous transfer) or interrupts are disabled, when they are closed/enabled again
+void drdyFalling(ADS129xChipSimulator *chip);
+}
+}
+}
+
+#endif /* _ADS129X_CHIP_SIMULATOR_H_ */
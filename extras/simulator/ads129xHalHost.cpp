@@ -0,0 +1,340 @@
+// Host backend of the hardware abstraction layer (see ads129xHal.h). Every SPI byte, pin and delay goes to the
+// ADS chip simulator (see ads129xChipSimulator.h).
+#include "ads129xChipSimulator.h"
+
+#if ADS_HAL_BACKEND == ADS_HAL_HOST_SIMULATOR
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+ADS129xChipSimulator chipSimulators[ADS_MAX_SENSORS];
+ADS129xChipSimulator *selectedChip = &chipSimulators[0]; // Chip of the open (or the last) SPI transaction
+
+// DRDY interruption of each chip
+void (*drdyIsrs[ADS_MAX_SENSORS])() = {NULL};
+// Like a real microcontroller, only one DRDY interruption per pin can be pending
+boolean isrPending[ADS_MAX_SENSORS] = {false};
+
+uint32_t spiClockHz = 1000000;
+boolean transactionOpen = false;
+boolean interruptsEnabled = true;
+boolean insideIsr = false;
+
+// The simulators and this state are used by your program and by the thread that emulates the DMA channel. Every HAL
+// function holds halMutex (it's recursive: the interruptions call HAL functions) and the interruptions run holding it
+pthread_mutex_t halMutex;
+pthread_once_t halMutexOnce = PTHREAD_ONCE_INIT;
+pthread_cond_t halChanged = PTHREAD_COND_INITIALIZER; // The time advances, the SPI bus is free, interrupts are enabled or a new transfer starts
+pthread_t dmaThread;
+boolean isDmaThreadRunning = false;
+
+// Asynchronous transfer started by spiTransferAsync(). The DMA thread transfers its bytes while your program runs
+// and calls onComplete as the completion interruption when the time reaches asyncDoneNs
+byte *asyncBuffer = NULL;
+uint16_t asyncBytes = 0;
+void (*asyncOnComplete)() = NULL;
+uint64_t asyncDoneNs = 0;
+
+void initHalMutex() {
+  pthread_mutexattr_t attributes;
+  pthread_mutexattr_init(&attributes);
+  pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&halMutex, &attributes);
+  pthread_mutexattr_destroy(&attributes);
+}
+
+class HalLock {
+  public:
+    HalLock() {
+      pthread_once(&halMutexOnce, initHalMutex);
+      pthread_mutex_lock(&halMutex);
+    }
+    ~HalLock() { pthread_mutex_unlock(&halMutex); }
+};
+
+// Chip connected to pin (its CS pin if isChipSelect is true, its DRDY pin otherwise). The first chip if no one is connected to it
+ADS129xChipSimulator *chipConnectedTo(uint8_t pin, boolean isChipSelect) {
+  for (uint8_t i = 0; i < ADS_MAX_SENSORS; i++) {
+    uint8_t chipPin = isChipSelect ? chipSimulators[i].getChipSelectPin() : chipSimulators[i].getDrdyPin();
+    if (chipPin == pin)
+      return &chipSimulators[i];
+  }
+  return &chipSimulators[0];
+}
+
+uint64_t nowNs() {
+  return chipSimulators[0].getNanoseconds();
+}
+
+// All the chips share the time
+void advanceNanoseconds(uint64_t ns) {
+  for (uint8_t i = 0; i < ADS_MAX_SENSORS; i++)
+    chipSimulators[i].advanceNanoseconds(ns);
+  pthread_cond_broadcast(&halChanged); // The DMA thread could be waiting for the end of its transfer
+}
+
+// Time that nBytes take at the SPI clock (8 SCLK periods per byte)
+uint64_t spiNanoseconds(uint32_t nBytes) {
+  return (8000000000ULL * nBytes + spiClockHz - 1) / spiClockHz;
+}
+
+boolean isDmaThread() {
+  return isDmaThreadRunning && pthread_equal(pthread_self(), dmaThread);
+}
+
+void spiTransferBytes(byte *buffer, uint16_t nBytes) {
+  for (uint16_t i = 0; i < nBytes; i++)
+    buffer[i] = ads::hal::spiTransfer(buffer[i]);
+}
+
+void runPendingIsr();
+
+// DMA channel. The bytes are transferred one by one, so your program (delays, pins, ...) and the DRDY interruptions
+// run between them. They don't take time of your program: the completion interruption is called when the time of your
+// program reaches the end of the transfer (asyncDoneNs). The SPI transaction opened by the interruption stays open until
+// the completion interruption
+void *dmaMain(void *) {
+  pthread_mutex_lock(&halMutex);
+  while (true) {
+    while (asyncOnComplete == NULL)
+      pthread_cond_wait(&halChanged, &halMutex);
+    byte *buffer = asyncBuffer;
+    uint16_t nBytes = asyncBytes;
+    void (*onComplete)() = asyncOnComplete;
+    for (uint16_t i = 0; i < nBytes; i++) {
+      buffer[i] = selectedChip->transfer(buffer[i]);
+      pthread_mutex_unlock(&halMutex);
+      sched_yield();
+      pthread_mutex_lock(&halMutex);
+    }
+
+    // Completion interruption. It waits while your program has disabled interrupts
+    while (nowNs() < asyncDoneNs || !interruptsEnabled)
+      pthread_cond_wait(&halChanged, &halMutex);
+    asyncOnComplete = NULL;
+    insideIsr = true;
+    onComplete();
+    insideIsr = false;
+    runPendingIsr();
+    pthread_cond_broadcast(&halChanged);
+  }
+  return NULL;
+}
+
+// The time of your program reached the end of the asynchronous transfer -> wait until the DMA thread calls the completion
+// interruption, like a real DMA channel that finishes at that time. Not while interrupts are disabled: the completion
+// waits for them (like any interruption)
+void waitForDueCompletion() {
+  while (asyncOnComplete != NULL && nowNs() >= asyncDoneNs && interruptsEnabled && !isDmaThread())
+    pthread_cond_wait(&halChanged, &halMutex);
+}
+
+// Time of the delays. With ADS_ASYNC_FRAME_READ, it advances in steps of 1 us (and up to the end of the asynchronous
+// transfer), so the interruptions are called at their time: the DRDY interruption at its edge and the completion one
+// when the transfer is done. The steps only split the time of your program, they don't add any
+void delayNanoseconds(uint64_t ns) {
+  if (!ADS_ASYNC_FRAME_READ) {
+    advanceNanoseconds(ns);
+    return;
+  }
+  uint64_t endNs = nowNs() + ns;
+  while (nowNs() < endNs) {
+    waitForDueCompletion();
+    uint64_t stepEndNs = nowNs() + 1000 < endNs ? nowNs() + 1000 : endNs;
+    if (asyncOnComplete != NULL && asyncDoneNs > nowNs() && asyncDoneNs < stepEndNs)
+      stepEndNs = asyncDoneNs;
+    advanceNanoseconds(stepEndNs - nowNs());
+  }
+  waitForDueCompletion();
+}
+
+// Execute the pending interruptions if nothing is masking them
+void runPendingIsr() {
+  boolean executed = true;
+  while (executed) {
+    executed = false;
+    for (uint8_t i = 0; i < ADS_MAX_SENSORS; i++) {
+      // The transaction of an asynchronous transfer doesn't mask them: the interruption that opened it has returned
+      boolean masked = (transactionOpen && asyncOnComplete == NULL) || !interruptsEnabled || insideIsr;
+      if (!isrPending[i] || drdyIsrs[i] == NULL || masked)
+        continue;
+      isrPending[i] = false;
+      insideIsr = true;
+      drdyIsrs[i]();
+      insideIsr = false;
+      executed = true;
+    }
+  }
+}
+}
+
+namespace ads {
+namespace hal {
+namespace host {
+ADS129xChipSimulator & simulator(uint8_t index) {
+  return chipSimulators[index];
+}
+
+void drdyFalling(ADS129xChipSimulator *chip) {
+  HalLock lock;
+  isrPending[chip - chipSimulators] = true;
+  runPendingIsr();
+}
+}
+
+/* ======= SPI ============= */
+void spiBegin() {}
+
+void spiBeginTransaction(uint8_t chipSelectPin, uint32_t clockHz) {
+  HalLock lock;
+  // The transaction of an asynchronous transfer is open -> your program waits until the end of the transfer and the
+  // DMA thread closes it in the completion interruption (see ads129xHal.h)
+  while (transactionOpen) {
+    if (asyncOnComplete != NULL && nowNs() < asyncDoneNs && !isDmaThread())
+      delayNanoseconds(asyncDoneNs - nowNs());
+    else
+      pthread_cond_wait(&halChanged, &halMutex);
+  }
+  transactionOpen = true;
+  spiClockHz = clockHz;
+  selectedChip = chipConnectedTo(chipSelectPin, true);
+  selectedChip->setChipSelect(true);
+}
+
+void spiEndTransaction(uint8_t chipSelectPin) {
+  (void) chipSelectPin;
+  HalLock lock;
+  selectedChip->setChipSelect(false);
+  transactionOpen = false;
+  pthread_cond_broadcast(&halChanged);
+  runPendingIsr();
+}
+
+byte spiTransfer(byte data) {
+  HalLock lock;
+  byte received = selectedChip->transfer(data);
+  advanceNanoseconds(spiNanoseconds(1));
+  return received;
+}
+
+void spiTransfer(byte *buffer, uint16_t nBytes) {
+  spiTransferBytes(buffer, nBytes);
+}
+
+void spiWrite(const byte *data, uint16_t nBytes) {
+  for (uint16_t i = 0; i < nBytes; i++)
+    spiTransfer(data[i]);
+}
+
+void spiReceive(byte *buffer, uint16_t nBytes) {
+  for (uint16_t i = 0; i < nBytes; i++)
+    buffer[i] = spiTransfer(0x00);
+}
+
+boolean spiTransferAsync(byte *buffer, uint16_t nBytes, void (*onComplete)()) {
+  HalLock lock;
+  if (!isDmaThreadRunning) {
+    if (pthread_create(&dmaThread, NULL, dmaMain, NULL) != 0)
+      return false;
+    pthread_detach(dmaThread);
+    isDmaThreadRunning = true;
+  }
+  for (uint16_t i = 0; i < nBytes; i++)
+    buffer[i] = 0x00;
+  asyncBuffer = buffer;
+  asyncBytes = nBytes;
+  asyncOnComplete = onComplete;
+  asyncDoneNs = nowNs() + spiNanoseconds(nBytes);
+  pthread_cond_broadcast(&halChanged);
+  return true;
+}
+
+/* ======= GPIO pins ============= */
+void setPinAsOutput(uint8_t pin) { (void) pin; }
+
+void setPinAsInput(uint8_t pin) { (void) pin; }
+
+void writePin(uint8_t pin, uint8_t level) {
+  HalLock lock;
+  for (uint8_t i = 0; i < ADS_MAX_SENSORS; i++)
+    chipSimulators[i].writePin(pin, level);
+}
+
+/* ======= Interrupts ============= */
+void attachDrdyInterrupt(uint8_t drdyPin, void (*isr)()) {
+  HalLock lock;
+  ADS129xChipSimulator *chip = chipConnectedTo(drdyPin, false);
+  drdyIsrs[chip - chipSimulators] = isr;
+  isrPending[chip - chipSimulators] = false;
+  chip->setDrdyCallback(host::drdyFalling);
+}
+
+void detachDrdyInterrupt(uint8_t drdyPin) {
+  HalLock lock;
+  ADS129xChipSimulator *chip = chipConnectedTo(drdyPin, false);
+  drdyIsrs[chip - chipSimulators] = NULL;
+  isrPending[chip - chipSimulators] = false;
+}
+
+void disableInterrupts() {
+  HalLock lock;
+  interruptsEnabled = false;
+}
+
+void enableInterrupts() {
+  HalLock lock;
+  interruptsEnabled = true;
+  pthread_cond_broadcast(&halChanged);
+  runPendingIsr();
+}
+
+/* ======= Time ============= */
+void delayMs(uint32_t ms) {
+  HalLock lock;
+  delayNanoseconds((uint64_t) ms * 1000000);
+}
+
+void delayUs(uint32_t us) {
+  HalLock lock;
+  delayNanoseconds((uint64_t) us * 1000);
+}
+
+uint32_t micros() {
+  HalLock lock;
+  return (uint32_t) (nowNs() / 1000);
+}
+
+/* ======= Messages ============= */
+void print(const char *msg) {
+  fputs(msg, stdout);
+}
+
+void println(const char *msg) {
+  puts(msg);
+}
+
+void println(uint32_t value, uint8_t base) {
+  char digits[33];
+  uint8_t n = 0;
+  do {
+    uint8_t digit = value % base;
+    digits[n++] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    value /= base;
+  } while (value > 0);
+  while (n > 0)
+    putchar(digits[--n]);
+  putchar('\n');
+}
+
+void halt() {
+  fflush(stdout);
+  abort();
+}
+
+} // End of the hal namespace
+} // End of the ads namespace
+
+#endif /* ADS_HAL_BACKEND == ADS_HAL_HOST_SIMULATOR */